@@ -0,0 +1,209 @@
+﻿#include "pch.h"
+#include "AnimationClip.h"
+#include "anim/AnimationPose.h"
+
+using namespace glm;
+
+
+namespace
+{
+	//カーソルから線形に進める最大キー数 超えたら二分探索に切り替える
+	const uint32 MaxCursorSteps = 4;
+
+	//最短経路の球面線形補間(ほぼ同じ向きなら正規化線形補間)
+	vec4
+	Slerp(const vec4& a, vec4 b, float32 s)
+	{
+		float32 d = dot(a, b);
+		if (d < 0.0f)
+		{
+			b = -b;
+			d = -d;
+		}
+		if (d > 0.9995f)
+		{
+			return normalize(a + (b - a) * s);
+		}
+		float32 theta = acosf(d);
+		float32 sinTheta = sinf(theta);
+		return (a * sinf((1.0f - s) * theta) + b * sinf(s * theta)) / sinTheta;
+	}
+}
+
+
+AnimationClip::
+AnimationClip()
+: m_tracks()
+, m_times()
+, m_values()
+, m_duration(0.0f)
+{
+}
+
+void AnimationClip::
+AddTrack(uint32 target, Path path, Interpolation interpolation, const float32* times, uint32 keyCount, const float32* values)
+{
+	if (keyCount == 0)
+	{
+		return;
+	}
+	Track track{};
+	track.target = target;
+	track.path = path;
+	track.interpolation = interpolation;
+	track.firstKey = uint32(m_times.size());
+	track.keyCount = keyCount;
+	track.firstValue = uint32(m_values.size());
+	m_tracks.push_back(track);
+
+	m_times.insert(m_times.end(), times, times + keyCount);
+	m_duration = (std::max)(m_duration, times[keyCount - 1]);
+
+	const uint32 components = (path == PathRotation) ? 4 : 3;
+	const uint32 valueCount = (interpolation == InterpolationCubicSpline) ? keyCount * 3 : keyCount;
+	for (uint32 idx=0; idx<valueCount; ++idx)
+	{
+		const float32* v = values + idx * components;
+		m_values.push_back(vec4(v[0], v[1], v[2], (components == 4) ? v[3] : 0.0f));
+	}
+}
+
+void AnimationClip::
+Clear(void)
+{
+	m_tracks.clear();
+	m_times.clear();
+	m_values.clear();
+	m_duration = 0.0f;
+}
+
+uint32 AnimationClip::
+GetByteSize(void) const
+{
+	uint32 size = 0;
+	for (const auto& track : m_tracks)
+	{
+		uint32 components = (track.path == PathRotation) ? 4 : 3;
+		uint32 valueCount = (track.interpolation == InterpolationCubicSpline) ? track.keyCount * 3 : track.keyCount;
+		size += uint32(sizeof(float32)) * (track.keyCount + valueCount * components);
+	}
+	return size;
+}
+
+void AnimationClip::
+Sample(float32 time, uint32* cursors, float32 weight, AnimationPose& pose) const
+{
+	if (weight <= 0.0f)
+	{
+		return;
+	}
+	for (uint32 trackIdx=0; trackIdx<GetTrackCount(); ++trackIdx)
+	{
+		const auto& track = m_tracks[trackIdx];
+		vec4 value = SampleTrack(trackIdx, time, (cursors != nullptr) ? &cursors[trackIdx] : nullptr);
+		AddToPose(track.target, track.path, value, weight, pose);
+	}
+}
+
+vec4 AnimationClip::
+SampleTrack(uint32 trackIdx, float32 time, uint32* cursor) const
+{
+	const auto& track = m_tracks[trackIdx];
+	const float32* times = &m_times[track.firstKey];
+	const vec4* values = &m_values[track.firstValue];
+	if (track.interpolation != InterpolationCubicSpline)
+	{
+		if (track.keyCount == 1)
+		{
+			return values[0];
+		}
+		uint32 key = FindKey(times, track.keyCount, time, cursor);
+		float32 dt = times[key + 1] - times[key];
+		float32 s = (dt > 0.0f) ? clamp((time - times[key]) / dt, 0.0f, 1.0f) : 0.0f;
+		return Interpolate(track.path, track.interpolation, values[key], values[key], values[key + 1], values[key + 1], s, dt);
+	}
+
+	//キーごとに入接線・値・出接線の順
+	if (track.keyCount == 1)
+	{
+		return values[1];
+	}
+	uint32 key = FindKey(times, track.keyCount, time, cursor);
+	float32 dt = times[key + 1] - times[key];
+	float32 s = (dt > 0.0f) ? clamp((time - times[key]) / dt, 0.0f, 1.0f) : 0.0f;
+	const vec4* k0 = &values[key * 3];
+	return Interpolate(track.path, track.interpolation, k0[1], k0[2], k0[3], k0[4], s, dt);
+}
+
+uint32 AnimationClip::
+FindKey(const float32* times, uint32 keyCount, float32 time, uint32* cursor)
+{
+	const uint32 lastSegment = keyCount - 2;
+
+	//前回の区間から後ろへ数キーだけ進めて探す(通常の再生ではほぼ0～1キー)
+	if (cursor != nullptr)
+	{
+		uint32 key = (std::min)(*cursor, lastSegment);
+		if (time >= times[key])
+		{
+			for (uint32 step=0; step<=MaxCursorSteps; ++step)
+			{
+				if (key == lastSegment || time < times[key + 1])
+				{
+					*cursor = key;
+					return key;
+				}
+				++key;
+			}
+		}
+	}
+
+	//ループで巻き戻ったときやシークしたときは二分探索
+	uint32 key = uint32(std::upper_bound(times, times + keyCount, time) - times);
+	key = (key == 0) ? 0 : (std::min)(key - 1, lastSegment);
+	if (cursor != nullptr)
+	{
+		*cursor = key;
+	}
+	return key;
+}
+
+vec4 AnimationClip::
+Interpolate(Path path, Interpolation interpolation, const vec4& v0, const vec4& v0Out, const vec4& v1In, const vec4& v1, float32 s, float32 dt)
+{
+	switch (interpolation)
+	{
+	case InterpolationStep:
+		return (s >= 1.0f) ? v1 : v0;
+	case InterpolationCubicSpline:
+		{
+			//エルミート補間
+			float32 s2 = s * s;
+			float32 s3 = s2 * s;
+			vec4 value = v0 * (2.0f * s3 - 3.0f * s2 + 1.0f)
+				+ v0Out * ((s3 - 2.0f * s2 + s) * dt)
+				+ v1 * (-2.0f * s3 + 3.0f * s2)
+				+ v1In * ((s3 - s2) * dt);
+			return (path == PathRotation) ? normalize(value) : value;
+		}
+	default:
+		return (path == PathRotation) ? Slerp(v0, v1, s) : v0 + (v1 - v0) * s;
+	}
+}
+
+void AnimationClip::
+AddToPose(uint32 target, Path path, const vec4& value, float32 weight, AnimationPose& pose)
+{
+	switch (path)
+	{
+	case PathTranslation:
+		pose.AddTranslation(target, vec3(value), weight);
+		break;
+	case PathRotation:
+		pose.AddRotation(target, quat(value.w, value.x, value.y, value.z), weight);
+		break;
+	case PathScale:
+		pose.AddScale(target, vec3(value), weight);
+		break;
+	}
+}
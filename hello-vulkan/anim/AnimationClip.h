@@ -0,0 +1,85 @@
+﻿#pragma once
+
+#include <vector>
+
+class AnimationPose;
+
+
+//アニメーションの1クリップ
+//glTFのチャンネルを1本ずつトラックにし、キー時刻と値をそれぞれ別の配列へトラックごとに連続して並べる
+//再生側はトラックごとに前回のキー位置(カーソル)を持ち、次の検索をそこから始める
+class AnimationClip
+{
+public:
+	enum Path
+	{
+		PathTranslation,
+		PathRotation,
+		PathScale,
+	};
+	enum Interpolation
+	{
+		InterpolationLinear,
+		InterpolationStep,
+		InterpolationCubicSpline,
+	};
+	struct Track
+	{
+		uint32 target;					//ポーズ内の番号
+		Path path;
+		Interpolation interpolation;
+		uint32 firstKey;				//m_timesの先頭
+		uint32 keyCount;
+		uint32 firstValue;				//m_valuesの先頭(CUBICSPLINEはキーごとに入接線・値・出接線の3個)
+	};
+
+public:
+	AnimationClip();
+
+	//valuesはキーごとの成分(平行移動・拡縮は3、回転はxyzwの4)をkeyCount個(CUBICSPLINEは3倍)並べたもの
+	void
+	AddTrack(uint32 target, Path path, Interpolation interpolation, const float32* times, uint32 keyCount, const float32* values);
+	void
+	Clear(void);
+	uint32
+	GetTrackCount(void) const { return uint32(m_tracks.size()); }
+	const Track&
+	GetTrack(uint32 track) const { return m_tracks[track]; }
+	//最後のキーの時刻
+	float32
+	GetDuration(void) const { return m_duration; }
+	//キー時刻と値を詰めて持った場合の大きさ(glTFのアクセサ相当)
+	uint32
+	GetByteSize(void) const;
+
+	//timeの値をweightを掛けてposeへ足す(ループさせるなら0～GetDurationに収めて渡す)
+	//cursorsはトラック数の配列(0で初期化しておく) nullptrなら毎回二分探索する
+	void
+	Sample(float32 time, uint32* cursors, float32 weight, AnimationPose& pose) const;
+	//1トラックの値(回転はxyzw)
+	glm::vec4
+	SampleTrack(uint32 track, float32 time, uint32* cursor) const;
+	//トラックのキー時刻と値(CUBICSPLINEは入接線・値・出接線の順)
+	const float32*
+	GetTimes(uint32 track) const { return &m_times[m_tracks[track].firstKey]; }
+	const glm::vec4*
+	GetValues(uint32 track) const { return &m_values[m_tracks[track].firstValue]; }
+
+public:
+	//times[key] <= time < times[key + 1]となるkeyを返す(範囲外は先頭・末尾の区間)
+	//cursorは前回の結果で、そこから数キーだけ進めて探す nullptrなら二分探索する
+	static uint32
+	FindKey(const float32* times, uint32 keyCount, float32 time, uint32* cursor);
+	//区間内の位置s(0～1)で前後のキーを補間する 接線(v0Out, v1In)はCUBICSPLINEのみ使う
+	static glm::vec4
+	Interpolate(Path path, Interpolation interpolation, const glm::vec4& v0, const glm::vec4& v0Out, const glm::vec4& v1In, const glm::vec4& v1, float32 s, float32 dt);
+	//valueにweightを掛けてposeへ足す
+	static void
+	AddToPose(uint32 target, Path path, const glm::vec4& value, float32 weight, AnimationPose& pose);
+
+private:
+	std::vector<Track> m_tracks;
+	std::vector<float32> m_times;
+	std::vector<glm::vec4> m_values;	//回転はxyzw、平行移動・拡縮はwを0で埋める
+	float32 m_duration;
+};
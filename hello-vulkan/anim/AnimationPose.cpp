@@ -0,0 +1,72 @@
+﻿#include "pch.h"
+#include "AnimationPose.h"
+#include "render/SceneGraph.h"
+
+using namespace glm;
+
+
+AnimationPose::
+AnimationPose()
+: m_translations()
+, m_rotations()
+, m_scales()
+{
+}
+
+void AnimationPose::
+Reset(uint32 targetCount)
+{
+	m_translations.assign(targetCount, vec4(0.0f));
+	m_rotations.assign(targetCount, vec4(0.0f));
+	m_scales.assign(targetCount, vec4(0.0f));
+}
+
+void AnimationPose::
+AddTranslation(uint32 target, const vec3& translation, float32 weight)
+{
+	m_translations[target] += vec4(translation * weight, weight);
+}
+
+void AnimationPose::
+AddRotation(uint32 target, const quat& rotation, float32 weight)
+{
+	//qと-qは同じ回転なので、足したものと逆向きなら反転してから足す
+	auto& sum = m_rotations[target];
+	vec4 q(rotation.x, rotation.y, rotation.z, rotation.w);
+	sum += (dot(sum, q) < 0.0f) ? q * -weight : q * weight;
+}
+
+void AnimationPose::
+AddScale(uint32 target, const vec3& scale, float32 weight)
+{
+	m_scales[target] += vec4(scale * weight, weight);
+}
+
+void AnimationPose::
+Apply(const uint32* targetNodes, SceneGraph& scene) const
+{
+	for (uint32 target=0; target<Size(); ++target)
+	{
+		uint32 node = targetNodes[target];
+		if (node == SceneGraph::InvalidNode)
+		{
+			continue;
+		}
+		const auto& t = m_translations[target];
+		if (t.w > 0.0f)
+		{
+			scene.SetTranslation(node, vec3(t) / t.w);
+		}
+		const auto& r = m_rotations[target];
+		float32 len = length(r);
+		if (len > 0.0f)
+		{
+			scene.SetRotation(node, quat(r.w / len, r.x / len, r.y / len, r.z / len));
+		}
+		const auto& s = m_scales[target];
+		if (s.w > 0.0f)
+		{
+			scene.SetScale(node, vec3(s) / s.w);
+		}
+	}
+}
@@ -0,0 +1,38 @@
+﻿#pragma once
+
+#include <vector>
+#include <glm/gtc/quaternion.hpp>
+
+class SceneGraph;
+
+
+//クリップをウェイト付きで重ねたローカルTRS
+//チャンネルごとにウェイトの合計で割って正規化し、どのクリップも触れていないチャンネルはシーンの値を残す
+class AnimationPose
+{
+public:
+	AnimationPose();
+
+	//足し込みをやめてtargetCount個を空にする
+	void
+	Reset(uint32 targetCount);
+	uint32
+	Size(void) const { return uint32(m_translations.size()); }
+
+	void
+	AddTranslation(uint32 target, const glm::vec3& translation, float32 weight);
+	//符号を先に足したものへそろえてから足す
+	void
+	AddRotation(uint32 target, const glm::quat& rotation, float32 weight);
+	void
+	AddScale(uint32 target, const glm::vec3& scale, float32 weight);
+
+	//targetNodes[target]のノードへ書き込む(InvalidNodeは飛ばす)
+	void
+	Apply(const uint32* targetNodes, SceneGraph& scene) const;
+
+private:
+	std::vector<glm::vec4> m_translations;	//xyz:ウェイトを掛けた和 w:ウェイトの和
+	std::vector<glm::vec4> m_rotations;		//xyzw:ウェイトを掛けた和
+	std::vector<glm::vec4> m_scales;		//xyz:ウェイトを掛けた和 w:ウェイトの和
+};
@@ -0,0 +1,326 @@
+﻿#include "pch.h"
+#include "CompressedClip.h"
+#include "anim/AnimationPose.h"
+
+using namespace glm;
+
+
+namespace
+{
+	//全キーがこれ以内に収まる平行移動・拡縮のトラックは1値にする
+	const float32 ConstantEpsilon = 1.0e-5f;
+	//回転は四元数どうしの距離(符号をそろえたもの)で比べる
+	const float32 ConstantRotationEpsilon = 1.0e-5f;
+	//最大成分以外の成分は±1/√2に収まる
+	const float32 SmallestThreeRange = 0.70710678f;
+	const float32 SmallestThreeSteps = 32767.0f;
+	const float32 RangeSteps = 65535.0f;
+
+	//最大成分の番号を2bitに分けて1・2語目の最上位へ入れる
+	void
+	EncodeSmallestThree(vec4 q, uint16* words)
+	{
+		q = normalize(q);
+		uint32 largest = 0;
+		for (uint32 c=1; c<4; ++c)
+		{
+			if (fabsf(q[c]) > fabsf(q[largest]))
+			{
+				largest = c;
+			}
+		}
+		//最大成分を正にすれば、残り3成分から符号まで戻せる
+		if (q[largest] < 0.0f)
+		{
+			q = -q;
+		}
+		uint32 w = 0;
+		for (uint32 c=0; c<4; ++c)
+		{
+			if (c == largest)
+			{
+				continue;
+			}
+			float32 n = clamp((q[c] + SmallestThreeRange) / (2.0f * SmallestThreeRange), 0.0f, 1.0f);
+			words[w++] = uint16(n * SmallestThreeSteps + 0.5f);
+		}
+		words[0] |= uint16((largest & 1) << 15);
+		words[1] |= uint16((largest >> 1) << 15);
+	}
+
+	vec4
+	DecodeSmallestThree(const uint16* words)
+	{
+		const float32 scale = 2.0f * SmallestThreeRange / SmallestThreeSteps;
+		uint32 largest = (words[0] >> 15) | ((words[1] >> 15) << 1);
+		float32 a = float32(words[0] & 0x7fff) * scale - SmallestThreeRange;
+		float32 b = float32(words[1] & 0x7fff) * scale - SmallestThreeRange;
+		float32 c = float32(words[2]) * scale - SmallestThreeRange;
+		float32 d = sqrtf((std::max)(0.0f, 1.0f - a * a - b * b - c * c));
+		switch (largest)
+		{
+		case 0:		return vec4(d, a, b, c);
+		case 1:		return vec4(a, d, b, c);
+		case 2:		return vec4(a, b, d, c);
+		default:	return vec4(a, b, c, d);
+		}
+	}
+
+	//符号をそろえた四元数の差の長さ
+	float32
+	QuatDistance(const vec4& a, const vec4& b)
+	{
+		return (dot(a, b) < 0.0f) ? length(a + b) : length(a - b);
+	}
+}
+
+
+CompressedClip::
+CompressedClip()
+: m_tracks()
+, m_times()
+, m_words()
+, m_constants()
+, m_ranges()
+, m_duration(0.0f)
+{
+}
+
+void CompressedClip::
+Compress(const AnimationClip& source)
+{
+	Clear();
+	m_duration = source.GetDuration();
+	for (uint32 trackIdx=0; trackIdx<source.GetTrackCount(); ++trackIdx)
+	{
+		const auto& src = source.GetTrack(trackIdx);
+		const float32* times = source.GetTimes(trackIdx);
+		const vec4* values = source.GetValues(trackIdx);
+		const bool cubic = (src.interpolation == AnimationClip::InterpolationCubicSpline);
+		const bool rotation = (src.path == AnimationClip::PathRotation);
+		const uint32 valueCount = cubic ? src.keyCount * 3 : src.keyCount;
+
+		Track track{};
+		track.target = src.target;
+		track.path = src.path;
+		track.interpolation = src.interpolation;
+		track.keyCount = src.keyCount;
+
+		//全キーの値が先頭と同じ(CUBICSPLINEは接線も0)なら1値にする
+		const vec4 first = cubic ? values[1] : values[0];
+		bool constant = true;
+		for (uint32 idx=0; idx<valueCount && constant; ++idx)
+		{
+			bool tangent = cubic && (idx % 3 != 1);
+			if (tangent)
+			{
+				constant = (length(values[idx]) <= ConstantEpsilon);
+			}
+			else if (rotation)
+			{
+				constant = (QuatDistance(values[idx], first) <= ConstantRotationEpsilon);
+			}
+			else
+			{
+				constant = (length(vec3(values[idx] - first)) <= ConstantEpsilon);
+			}
+		}
+		if (constant)
+		{
+			track.format = FormatConstant;
+			track.keyCount = 1;
+			track.first = uint32(m_constants.size());
+			m_constants.push_back(rotation ? normalize(first) : first);
+			m_tracks.push_back(track);
+			continue;
+		}
+
+		track.firstTime = _AddTimes(times, src.keyCount);
+		track.firstWord = uint32(m_words.size());
+
+		//CUBICSPLINEの回転は接線が単位四元数ではないので範囲で量子化する
+		if (rotation && !cubic)
+		{
+			track.format = FormatSmallestThree;
+			track.words = 3;
+			m_words.resize(m_words.size() + valueCount * 3);
+			for (uint32 idx=0; idx<valueCount; ++idx)
+			{
+				EncodeSmallestThree(values[idx], &m_words[track.firstWord + idx * 3]);
+			}
+			m_tracks.push_back(track);
+			continue;
+		}
+
+		//トラックの値の範囲を成分ごとに16bitへ割り当てる
+		track.format = FormatRange;
+		track.words = rotation ? 4 : 3;
+		track.first = uint32(m_ranges.size());
+		vec4 minValue = values[0];
+		vec4 maxValue = values[0];
+		for (uint32 idx=1; idx<valueCount; ++idx)
+		{
+			minValue = glm::min(minValue, values[idx]);
+			maxValue = glm::max(maxValue, values[idx]);
+		}
+		vec4 step = (maxValue - minValue) / RangeSteps;
+		m_ranges.push_back(minValue);
+		m_ranges.push_back(step);
+		for (uint32 idx=0; idx<valueCount; ++idx)
+		{
+			for (uint32 c=0; c<track.words; ++c)
+			{
+				float32 n = (step[c] > 0.0f) ? (values[idx][c] - minValue[c]) / step[c] : 0.0f;
+				m_words.push_back(uint16(clamp(n, 0.0f, RangeSteps) + 0.5f));
+			}
+		}
+		m_tracks.push_back(track);
+	}
+}
+
+void CompressedClip::
+Clear(void)
+{
+	m_tracks.clear();
+	m_times.clear();
+	m_words.clear();
+	m_constants.clear();
+	m_ranges.clear();
+	m_duration = 0.0f;
+}
+
+uint32 CompressedClip::
+GetByteSize(void) const
+{
+	return uint32(m_tracks.size() * sizeof(Track)
+		+ m_times.size() * sizeof(float32)
+		+ m_words.size() * sizeof(uint16)
+		+ m_constants.size() * sizeof(vec4)
+		+ m_ranges.size() * sizeof(vec4));
+}
+
+uint32 CompressedClip::
+GetConstantTrackCount(void) const
+{
+	uint32 count = 0;
+	for (const auto& track : m_tracks)
+	{
+		count += (track.format == FormatConstant) ? 1 : 0;
+	}
+	return count;
+}
+
+void CompressedClip::
+Sample(float32 time, uint32* cursors, float32 weight, AnimationPose& pose) const
+{
+	if (weight <= 0.0f)
+	{
+		return;
+	}
+	for (uint32 trackIdx=0; trackIdx<GetTrackCount(); ++trackIdx)
+	{
+		const auto& track = m_tracks[trackIdx];
+		vec4 value = SampleTrack(trackIdx, time, (cursors != nullptr) ? &cursors[trackIdx] : nullptr);
+		AnimationClip::AddToPose(track.target, track.path, value, weight, pose);
+	}
+}
+
+vec4 CompressedClip::
+SampleTrack(uint32 trackIdx, float32 time, uint32* cursor) const
+{
+	const auto& track = m_tracks[trackIdx];
+	if (track.format == FormatConstant)
+	{
+		return m_constants[track.first];
+	}
+	const bool cubic = (track.interpolation == AnimationClip::InterpolationCubicSpline);
+	if (track.keyCount == 1)
+	{
+		return _Decode(track, cubic ? 1 : 0);
+	}
+
+	const float32* times = &m_times[track.firstTime];
+	uint32 key = AnimationClip::FindKey(times, track.keyCount, time, cursor);
+	float32 dt = times[key + 1] - times[key];
+	float32 s = (dt > 0.0f) ? clamp((time - times[key]) / dt, 0.0f, 1.0f) : 0.0f;
+	if (!cubic)
+	{
+		vec4 v0 = _Decode(track, key);
+		vec4 v1 = _Decode(track, key + 1);
+		return AnimationClip::Interpolate(track.path, track.interpolation, v0, v0, v1, v1, s, dt);
+	}
+	//キーごとに入接線・値・出接線の順
+	return AnimationClip::Interpolate(track.path, track.interpolation,
+		_Decode(track, key * 3 + 1), _Decode(track, key * 3 + 2), _Decode(track, key * 3 + 3), _Decode(track, key * 3 + 4), s, dt);
+}
+
+void CompressedClip::
+MeasureError(const AnimationClip& source, uint32 targetCount, std::vector<Error>& errors) const
+{
+	errors.assign(targetCount, Error{ 0.0f, 0.0f, 0.0f });
+	for (uint32 trackIdx=0; trackIdx<GetTrackCount() && trackIdx<source.GetTrackCount(); ++trackIdx)
+	{
+		const auto& track = m_tracks[trackIdx];
+		const auto& src = source.GetTrack(trackIdx);
+		if (track.target >= targetCount)
+		{
+			continue;
+		}
+		const float32* times = source.GetTimes(trackIdx);
+		auto& error = errors[track.target];
+		for (uint32 key=0; key<src.keyCount * 2 - 1; ++key)
+		{
+			//偶数はキー、奇数は前後のキーの中間
+			float32 t = (key % 2 == 0) ? times[key / 2] : (times[key / 2] + times[key / 2 + 1]) * 0.5f;
+			vec4 a = source.SampleTrack(trackIdx, t, nullptr);
+			vec4 b = SampleTrack(trackIdx, t, nullptr);
+			switch (track.path)
+			{
+			case AnimationClip::PathTranslation:
+				error.translation = (std::max)(error.translation, length(vec3(a - b)));
+				break;
+			case AnimationClip::PathRotation:
+				//四元数の弦の長さから回転角の差へ
+				error.rotation = (std::max)(error.rotation, 4.0f * asinf((std::min)(1.0f, QuatDistance(a, b) * 0.5f)));
+				break;
+			case AnimationClip::PathScale:
+				{
+					vec3 d = abs(vec3(a - b));
+					error.scale = (std::max)(error.scale, (std::max)(d.x, (std::max)(d.y, d.z)));
+				}
+				break;
+			}
+		}
+	}
+}
+
+vec4 CompressedClip::
+_Decode(const Track& track, uint32 index) const
+{
+	const uint16* words = &m_words[track.firstWord + index * track.words];
+	if (track.format == FormatSmallestThree)
+	{
+		return DecodeSmallestThree(words);
+	}
+	const vec4& minValue = m_ranges[track.first];
+	const vec4& step = m_ranges[track.first + 1];
+	float32 w = (track.words == 4) ? float32(words[3]) : 0.0f;
+	return minValue + vec4(words[0], words[1], words[2], w) * step;
+}
+
+uint32 CompressedClip::
+_AddTimes(const float32* times, uint32 keyCount)
+{
+	//glTFでは同じサンプラーの入力をチャンネル間で共有していることが多い
+	for (const auto& track : m_tracks)
+	{
+		if (track.format != FormatConstant && track.keyCount == keyCount &&
+			memcmp(&m_times[track.firstTime], times, keyCount * sizeof(float32)) == 0)
+		{
+			return track.firstTime;
+		}
+	}
+	uint32 first = uint32(m_times.size());
+	m_times.insert(m_times.end(), times, times + keyCount);
+	return first;
+}
@@ -0,0 +1,88 @@
+﻿#pragma once
+
+#include <vector>
+#include "anim/AnimationClip.h"
+
+class AnimationPose;
+
+
+//AnimationClipを量子化して小さく持つクリップ
+//回転は最大成分を除いた3成分を15bitずつ(smallest-three)、平行移動・拡縮はトラックごとの範囲に対する16bitで持つ
+//全キーがほぼ同じ値のトラックは1値だけ残し、同じキー時刻の配列はトラック間で共有する
+//再生はAnimationClipと同じカーソルを使い、必要な2キーだけをその場で戻して補間する
+class CompressedClip
+{
+public:
+	enum Format
+	{
+		FormatConstant,			//m_constants[first]の1値
+		FormatSmallestThree,	//キーごとにuint16×3
+		FormatRange,			//キーごとにuint16×成分数 範囲はm_ranges[first]から最小値・幅の2個
+	};
+	struct Track
+	{
+		uint32 target;
+		AnimationClip::Path path;
+		AnimationClip::Interpolation interpolation;
+		Format format;
+		uint32 keyCount;
+		uint32 firstTime;		//m_timesの先頭
+		uint32 firstWord;		//m_wordsの先頭
+		uint32 first;			//m_constantsまたはm_rangesの先頭
+		uint32 words;			//1値あたりのuint16の数
+	};
+	//ターゲットごとの最大誤差
+	struct Error
+	{
+		float32 translation;	//距離
+		float32 rotation;		//角度(ラジアン)
+		float32 scale;			//成分の差
+	};
+
+public:
+	CompressedClip();
+
+	//sourceを量子化して作り直す
+	void
+	Compress(const AnimationClip& source);
+	void
+	Clear(void);
+	uint32
+	GetTrackCount(void) const { return uint32(m_tracks.size()); }
+	const Track&
+	GetTrack(uint32 track) const { return m_tracks[track]; }
+	float32
+	GetDuration(void) const { return m_duration; }
+	//圧縮後の大きさ(トラック情報を含む)
+	uint32
+	GetByteSize(void) const;
+	//1値だけにしたトラックの数
+	uint32
+	GetConstantTrackCount(void) const;
+
+	//AnimationClip::Sampleと同じ(cursorsはトラック数の配列)
+	void
+	Sample(float32 time, uint32* cursors, float32 weight, AnimationPose& pose) const;
+	glm::vec4
+	SampleTrack(uint32 track, float32 time, uint32* cursor) const;
+
+	//圧縮元のキーとキーの中間でsourceと比べ、ターゲットごとの最大誤差をerrorsへ書く(targetCount個)
+	void
+	MeasureError(const AnimationClip& source, uint32 targetCount, std::vector<Error>& errors) const;
+
+private:
+	//トラックのindex番目の値を戻す
+	glm::vec4
+	_Decode(const Track& track, uint32 index) const;
+	//同じキー時刻の配列がすでにあればその先頭、なければ追加した先頭
+	uint32
+	_AddTimes(const float32* times, uint32 keyCount);
+
+private:
+	std::vector<Track> m_tracks;
+	std::vector<float32> m_times;
+	std::vector<uint16> m_words;
+	std::vector<glm::vec4> m_constants;
+	std::vector<glm::vec4> m_ranges;		//トラックごとに最小値・幅/65535の2個
+	float32 m_duration;
+};
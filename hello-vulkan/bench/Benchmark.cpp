@@ -0,0 +1,575 @@
+﻿#include "pch.h"
+#include "Benchmark.h"
+#include <chrono>
+#include <random>
+#include "anim/AnimationClip.h"
+#include "anim/AnimationPose.h"
+#include "anim/CompressedClip.h"
+#include "job/JobSystem.h"
+#include "render/BoundsTable.h"
+#include "render/CrowdScene.h"
+#include "render/Frustum.h"
+#include "render/FrustumCuller.h"
+#include "render/MorphTargets.h"
+#include "render/SceneGraph.h"
+#include "render/SkinPalette.h"
+
+using namespace glm;
+
+
+namespace
+{
+	//fnを繰り返し実行し、1回あたりのミリ秒を返す
+	template <typename Fn>
+	float64
+	MeasureMs(uint32 iterations, Fn fn)
+	{
+		//キャッシュを温めるため1回は捨てる
+		fn();
+		auto begin = std::chrono::high_resolution_clock::now();
+		for (uint32 idx=0; idx<iterations; ++idx)
+		{
+			fn();
+		}
+		auto end = std::chrono::high_resolution_clock::now();
+		return std::chrono::duration<float64, std::milli>(end - begin).count() / iterations;
+	}
+}
+
+
+void Benchmark::
+Run(void)
+{
+	OutputDebugStringA("[Benchmark] begin\n");
+	_RunJobSystem();
+	_RunFrustumCulling();
+	_RunCrowdUpdate();
+	_RunSceneGraphUpdate();
+	_RunSkinning();
+	_RunAnimationSampling();
+	_RunClipCompression();
+	_RunMorphTargets();
+	OutputDebugStringA("[Benchmark] end\n");
+}
+
+void Benchmark::
+_RunJobSystem(void)
+{
+	//スレッド数ごとに、空のジョブを積んで待つまでの時間・ワーカーが動き出すまでの時間・ParallelForの効率を測る
+	const uint32 spawnCount = 10000;
+	const uint32 elementCount = 1 << 20;
+	std::vector<float32> values(elementCount);
+	float64 serialMs[2] = { 0.0, 0.0 };
+	for (uint32 threads=1; threads<=JobSystem::GetHardwareThreadCount(); ++threads)
+	{
+		JobSystem jobs;
+		jobs.Start(threads - 1);
+
+		//積むのはメインスレッドのみで、ワーカーは盗んで実行する
+		auto empty = [](void*, uint32, uint32) {};
+		float64 spawnMs = MeasureMs(100, [&]() {
+			JobCounter counter;
+			for (uint32 idx=0; idx<spawnCount; ++idx)
+			{
+				jobs.Spawn(Job{ empty, nullptr, 0, 0, &counter });
+			}
+			jobs.Wait(counter);
+		});
+		{
+			std::stringstream note;
+			note << "threads=" << threads << " " << (spawnMs * 1.0e6 / spawnCount) << "ns/job";
+			_Report("job spawn+wait", spawnCount, spawnMs, note.str().c_str());
+		}
+
+		//メインスレッドは手伝わずに、ワーカーが取って実行し終えるまでの往復
+		if (threads > 1)
+		{
+			std::atomic<uint32> done(0);
+			auto signal = [](void* data, uint32, uint32) { reinterpret_cast<std::atomic<uint32>*>(data)->store(1, std::memory_order_release); };
+			float64 wakeMs = MeasureMs(1000, [&]() {
+				done.store(0, std::memory_order_relaxed);
+				jobs.Spawn(Job{ signal, &done, 0, 0, nullptr });
+				while (done.load(std::memory_order_acquire) == 0)
+				{
+					std::this_thread::yield();
+				}
+			});
+			std::stringstream note;
+			note << "threads=" << threads << " " << (wakeMs * 1.0e3) << "us";
+			_Report("job steal latency", 1, wakeMs, note.str().c_str());
+		}
+
+		//要素ごとに少し計算するループを、細かいチャンクと粗いチャンクで分ける
+		const uint32 chunkSizes[] = { 256, 16384 };
+		for (uint32 c=0; c<2; ++c)
+		{
+			float64 ms = MeasureMs(20, [&]() {
+				jobs.ParallelFor(elementCount, chunkSizes[c], [&](uint32 begin, uint32 end) {
+					for (uint32 idx=begin; idx<end; ++idx)
+					{
+						float32 x = float32(idx);
+						values[idx] = sqrtf(x) * sinf(x) + cosf(x * 0.5f);
+					}
+				});
+			});
+			if (threads == 1)
+			{
+				serialMs[c] = ms;
+			}
+			float64 speedup = (ms > 0.0) ? serialMs[c] / ms : 0.0;
+
+			std::stringstream note;
+			note << "threads=" << threads << " chunk=" << chunkSizes[c] << " speedup=" << speedup << " efficiency=" << (speedup / threads);
+			_Report("parallel for", elementCount, ms, note.str().c_str());
+		}
+	}
+}
+
+void Benchmark::
+_RunFrustumCulling(void)
+{
+	//ModelAppと同じカメラで、周囲の立方体内に物体をばらまく
+	const vec3 eye(0.0f, 1.5f, -1.0f);
+	auto viewProj = perspective(radians(45.0f), 1280.0f / 720.0f, 0.01f, 100.0f) * lookAtRH(eye, vec3(0.0f, 1.25f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+	auto frustum = Frustum::FromMatrix(viewProj);
+
+	for (uint32 objectCount : {10000u, 100000u})
+	{
+		std::mt19937 rng(objectCount);
+		std::uniform_real_distribution<float32> position(-50.0f, 50.0f);
+		std::uniform_real_distribution<float32> extent(0.1f, 2.0f);
+		BoundsTable bounds;
+		for (uint32 idx=0; idx<objectCount; ++idx)
+		{
+			vec3 center(position(rng), position(rng), position(rng));
+			vec3 half(extent(rng), extent(rng), extent(rng));
+			bounds.Add(center - half, center + half, center, length(half));
+		}
+
+		std::vector<uint32> visible;
+		const uint32 iterations = 2000000 / objectCount;
+		struct
+		{
+			const char* name;
+			FrustumCuller::Path path;
+		} paths[] = {
+			{ "frustum cull scalar", FrustumCuller::PathScalar },
+			{ "frustum cull sse", FrustumCuller::PathSse },
+			{ "frustum cull avx", FrustumCuller::PathAvx },
+		};
+		for (const auto& p : paths)
+		{
+			if (p.path == FrustumCuller::PathAvx && !FrustumCuller::IsAvxSupported())
+			{
+				continue;
+			}
+			uint32 visibleCount = 0;
+			float64 ms = MeasureMs(iterations, [&]() { visibleCount = FrustumCuller::Cull(frustum, bounds, visible, p.path); });
+
+			std::stringstream note;
+			note << "visible=" << visibleCount;
+			_Report(p.name, objectCount, ms, note.str().c_str());
+		}
+	}
+}
+
+void Benchmark::
+_RunCrowdUpdate(void)
+{
+	//ModelAppの群衆モード(-crowd)と同じカメラで、インスタンスバッファを作るまでのCPU時間
+	const vec3 eye(0.0f, 6.0f, -6.0f);
+	auto viewProj = perspective(radians(45.0f), 1280.0f / 720.0f, 0.01f, 300.0f) * lookAtRH(eye, vec3(0.0f, 1.0f, 12.0f), vec3(0.0f, 1.0f, 0.0f));
+	auto frustum = Frustum::FromMatrix(viewProj);
+
+	for (uint32 avatarCount : {1000u, 10000u, 50000u})
+	{
+		CrowdScene crowd;
+		crowd.Build(avatarCount, vec3(0.0f, 0.8f, 0.0f), 0.9f);
+		uint32 visibleCount = 0;
+		const uint32 iterations = 5000000 / avatarCount;
+		float64 ms = MeasureMs(iterations, [&]() { visibleCount = crowd.Update(frustum, eye, radians(45.0f), LodSelector::MaxLods); });
+
+		std::stringstream note;
+		note << "visible=" << visibleCount;
+		for (uint32 lod=0; lod<LodSelector::MaxLods; ++lod)
+		{
+			note << " lod" << lod << "=" << (crowd.GetLodStart(lod + 1) - crowd.GetLodStart(lod));
+		}
+		_Report("crowd update", avatarCount, ms, note.str().c_str());
+	}
+}
+
+void Benchmark::
+_RunSceneGraphUpdate(void)
+{
+	//VRMの骨格程度(64ノード・8段)のアバターを並べ、段ごとに全アバターのノードが続くよう幅優先で追加する
+	const uint32 levelSizes[] = { 1, 3, 6, 10, 14, 14, 10, 6 };
+	const uint32 levelCount = sizeof(levelSizes) / sizeof(levelSizes[0]);
+	std::mt19937 rng(64);
+	std::uniform_real_distribution<float32> unit(-1.0f, 1.0f);
+
+	for (uint32 avatarCount : {100u, 1000u})
+	{
+		SceneGraph scene;
+		std::vector<uint32> prevLevel, curLevel;	//アバター×段内の番号 → ノード
+		std::vector<uint32> roots;
+		for (uint32 level=0; level<levelCount; ++level)
+		{
+			curLevel.assign(avatarCount * levelSizes[level], SceneGraph::InvalidNode);
+			for (uint32 avatar=0; avatar<avatarCount; ++avatar)
+			{
+				for (uint32 idx=0; idx<levelSizes[level]; ++idx)
+				{
+					uint32 parent = (level == 0) ? SceneGraph::InvalidNode : prevLevel[avatar * levelSizes[level - 1] + rng() % levelSizes[level - 1]];
+					vec3 translation(unit(rng), unit(rng), unit(rng));
+					quat rotation = normalize(quat(unit(rng), unit(rng), unit(rng), unit(rng)));
+					curLevel[avatar * levelSizes[level] + idx] = scene.AddNode(parent, translation, rotation, vec3(1.0f));
+				}
+			}
+			if (level == 0)
+			{
+				roots = curLevel;
+			}
+			prevLevel.swap(curLevel);
+		}
+
+		//毎回すべての根を動かし、全ノードを更新させる
+		const uint32 nodeCount = scene.Size();
+		const uint32 iterations = 4000000 / nodeCount;
+		float64 serialMs = 0.0;
+		for (uint32 threads=1; threads<=JobSystem::GetHardwareThreadCount(); ++threads)
+		{
+			JobSystem jobs;
+			jobs.Start(threads - 1);
+			uint32 frame = 0;
+			float64 ms = MeasureMs(iterations, [&]() {
+				float32 angle = float32(++frame) * 0.01f;
+				for (auto root : roots)
+				{
+					scene.SetRotation(root, quat(cosf(angle), 0.0f, sinf(angle), 0.0f));
+				}
+				scene.Update(&jobs);
+			});
+			if (threads == 1)
+			{
+				serialMs = ms;
+			}
+
+			std::stringstream note;
+			note << "threads=" << threads << " levels=" << scene.GetLevelCount() << " speedup=" << (ms > 0.0 ? serialMs / ms : 0.0);
+			_Report("scene graph update", nodeCount, ms, note.str().c_str());
+		}
+	}
+}
+
+void Benchmark::
+_RunSkinning(void)
+{
+	//VRMの骨格程度(64関節)の鎖に、ランダムな4関節・ウェイトの頂点を付ける
+	const uint32 jointCount = 64;
+	std::mt19937 rng(jointCount);
+	std::uniform_real_distribution<float32> unit(-1.0f, 1.0f);
+	SceneGraph scene;
+	std::vector<uint32> jointNodes;
+	for (uint32 idx=0; idx<jointCount; ++idx)
+	{
+		uint32 parent = (idx == 0) ? SceneGraph::InvalidNode : jointNodes[rng() % idx];
+		jointNodes.push_back(scene.AddNode(parent, vec3(0.0f, 0.1f, 0.0f), quat(1.0f, 0.0f, 0.0f, 0.0f), vec3(1.0f)));
+	}
+	scene.Update();
+	SkinPalette skins;
+	skins.AddSkin(jointNodes, std::vector<mat4>());
+	std::vector<mat4> palette(skins.Size());
+
+	for (uint32 vertexCount : {10000u, 100000u})
+	{
+		std::vector<vec3> positions(vertexCount);
+		std::vector<SkinPalette::SkinVertex> skinVertices(vertexCount);
+		for (uint32 idx=0; idx<vertexCount; ++idx)
+		{
+			positions[idx] = vec3(unit(rng), unit(rng), unit(rng));
+			auto& sv = skinVertices[idx];
+			float32 sum = 0.0f;
+			for (uint32 k=0; k<SkinPalette::MaxInfluences; ++k)
+			{
+				sv.joints[k] = uint16(rng() % jointCount);
+				sv.weights[k] = unit(rng) * 0.5f + 0.5f;
+				sum += sv.weights[k];
+			}
+			for (uint32 k=0; k<SkinPalette::MaxInfluences; ++k)
+			{
+				sv.weights[k] /= sum;
+			}
+		}
+		std::vector<vec3> skinned(vertexCount);
+
+		//毎回関節を動かし、パレットの計算から位置のスキニングまでを計る
+		const uint32 iterations = 20000000 / vertexCount;
+		uint32 frame = 0;
+		float64 ms = MeasureMs(iterations, [&]() {
+			float32 angle = float32(++frame) * 0.01f;
+			scene.SetRotation(jointNodes[0], quat(cosf(angle), 0.0f, sinf(angle), 0.0f));
+			scene.Update();
+			skins.Compute(scene, palette.data());
+			SkinPalette::SkinPositions(palette.data(), skinVertices.data(), positions.data(), vertexCount, skinned.data());
+		});
+
+		std::stringstream note;
+		note << "joints=" << jointCount << " " << (ms * 1.0e6 / vertexCount) << "ns/vertex";
+		_Report("cpu skinning", vertexCount, ms, note.str().c_str());
+	}
+}
+
+void Benchmark::
+_RunAnimationSampling(void)
+{
+	//64関節のキャラクター用に、30fpsで2秒の2クリップ(平行移動・回転・拡縮)を作る
+	//補間は回転がLINEAR、平行移動が4本に1本CUBICSPLINE、拡縮がSTEP
+	const uint32 boneCount = 64;
+	const uint32 keyCount = 61;
+	std::mt19937 rng(boneCount);
+	std::uniform_real_distribution<float32> unit(-1.0f, 1.0f);
+	AnimationClip clips[2];
+	for (auto& clip : clips)
+	{
+		std::vector<float32> times(keyCount);
+		for (uint32 key=0; key<keyCount; ++key)
+		{
+			times[key] = float32(key) / 30.0f;
+		}
+		for (uint32 bone=0; bone<boneCount; ++bone)
+		{
+			bool cubic = (bone % 4) == 0;
+			std::vector<float32> values;
+			for (uint32 idx=0; idx<keyCount * (cubic ? 3 : 1) * 3; ++idx)
+			{
+				values.push_back(unit(rng));
+			}
+			clip.AddTrack(bone, AnimationClip::PathTranslation, cubic ? AnimationClip::InterpolationCubicSpline : AnimationClip::InterpolationLinear, times.data(), keyCount, values.data());
+
+			values.clear();
+			for (uint32 key=0; key<keyCount; ++key)
+			{
+				quat q = normalize(quat(unit(rng), unit(rng), unit(rng), unit(rng)));
+				values.insert(values.end(), { q.x, q.y, q.z, q.w });
+			}
+			clip.AddTrack(bone, AnimationClip::PathRotation, AnimationClip::InterpolationLinear, times.data(), keyCount, values.data());
+
+			values.assign(keyCount * 3, 1.0f);
+			clip.AddTrack(bone, AnimationClip::PathScale, AnimationClip::InterpolationStep, times.data(), keyCount, values.data());
+		}
+	}
+
+	for (uint32 characterCount : {100u, 500u})
+	{
+		//キャラクターごとに再生位置をずらし、2クリップを7:3で重ねてノードへ書き込む
+		SceneGraph scene;
+		std::vector<uint32> targetNodes(characterCount * boneCount);
+		for (uint32 idx=0; idx<characterCount * boneCount; ++idx)
+		{
+			uint32 bone = idx % boneCount;
+			targetNodes[idx] = scene.AddNode((bone == 0) ? SceneGraph::InvalidNode : targetNodes[idx - bone], vec3(0.0f), quat(1.0f, 0.0f, 0.0f, 0.0f), vec3(1.0f));
+		}
+		const uint32 trackCount = clips[0].GetTrackCount();
+		const float32 duration = clips[0].GetDuration();
+		const uint32 bones = characterCount * boneCount;
+		const uint32 iterations = 2000000 / bones;
+		AnimationPose pose;
+
+		for (bool useCursor : {true, false})
+		{
+			std::vector<uint32> cursors(characterCount * trackCount * 2, 0);
+			std::vector<float32> times(characterCount);
+			for (uint32 idx=0; idx<characterCount; ++idx)
+			{
+				times[idx] = duration * float32(idx) / float32(characterCount);
+			}
+			float64 ms = MeasureMs(iterations, [&]() {
+				for (uint32 idx=0; idx<characterCount; ++idx)
+				{
+					times[idx] = fmodf(times[idx] + 1.0f / 60.0f, duration);
+					uint32* cursorA = useCursor ? &cursors[idx * trackCount * 2] : nullptr;
+					uint32* cursorB = useCursor ? cursorA + trackCount : nullptr;
+					pose.Reset(boneCount);
+					clips[0].Sample(times[idx], cursorA, 0.7f, pose);
+					clips[1].Sample(times[idx], cursorB, 0.3f, pose);
+					pose.Apply(&targetNodes[idx * boneCount], scene);
+				}
+			});
+
+			std::stringstream note;
+			note << "characters=" << characterCount << " clips=2 keys=" << keyCount << " " << (useCursor ? "cursor" : "binary-search") << " " << (ms * 1.0e6 / bones) << "ns/bone";
+			_Report("animation sampling", bones, ms, note.str().c_str());
+		}
+	}
+}
+
+void Benchmark::
+_RunClipCompression(void)
+{
+	//64関節・30fpsで2秒のクリップを、モーションキャプチャ程度のなめらかな動きで作る
+	//平行移動は根だけが動き、ほかの関節は骨の長さで止まっている 拡縮は全関節で1のまま
+	const uint32 boneCount = 64;
+	const uint32 keyCount = 61;
+	std::mt19937 rng(keyCount);
+	std::uniform_real_distribution<float32> unit(-1.0f, 1.0f);
+	std::vector<float32> times(keyCount);
+	for (uint32 key=0; key<keyCount; ++key)
+	{
+		times[key] = float32(key) / 30.0f;
+	}
+	AnimationClip clip;
+	for (uint32 bone=0; bone<boneCount; ++bone)
+	{
+		vec3 offset(unit(rng), unit(rng), unit(rng));
+		vec3 axis = normalize(vec3(unit(rng), unit(rng), unit(rng)));
+		float32 phase = unit(rng) * 3.0f;
+		std::vector<float32> values;
+		for (uint32 key=0; key<keyCount; ++key)
+		{
+			vec3 t = (bone == 0) ? offset + vec3(sinf(times[key] * 3.0f), 0.1f * cosf(times[key] * 6.0f), times[key] * 1.4f) : offset * 0.1f;
+			values.insert(values.end(), { t.x, t.y, t.z });
+		}
+		clip.AddTrack(bone, AnimationClip::PathTranslation, AnimationClip::InterpolationLinear, times.data(), keyCount, values.data());
+
+		values.clear();
+		for (uint32 key=0; key<keyCount; ++key)
+		{
+			quat q = angleAxis(0.8f * sinf(times[key] * 3.0f + phase), axis);
+			values.insert(values.end(), { q.x, q.y, q.z, q.w });
+		}
+		clip.AddTrack(bone, AnimationClip::PathRotation, AnimationClip::InterpolationLinear, times.data(), keyCount, values.data());
+
+		values.assign(keyCount * 3, 1.0f);
+		clip.AddTrack(bone, AnimationClip::PathScale, AnimationClip::InterpolationLinear, times.data(), keyCount, values.data());
+	}
+
+	CompressedClip compressed;
+	float64 compressMs = MeasureMs(100, [&]() { compressed.Compress(clip); });
+	std::vector<CompressedClip::Error> errors;
+	compressed.MeasureError(clip, boneCount, errors);
+	CompressedClip::Error worst{ 0.0f, 0.0f, 0.0f };
+	for (const auto& error : errors)
+	{
+		worst.translation = (std::max)(worst.translation, error.translation);
+		worst.rotation = (std::max)(worst.rotation, error.rotation);
+		worst.scale = (std::max)(worst.scale, error.scale);
+	}
+	{
+		std::stringstream note;
+		note << "bones=" << boneCount << " keys=" << keyCount << " " << clip.GetByteSize() << "->" << compressed.GetByteSize() << "bytes"
+			<< " ratio=" << (float32(clip.GetByteSize()) / float32(compressed.GetByteSize()))
+			<< " constant=" << compressed.GetConstantTrackCount() << "/" << compressed.GetTrackCount()
+			<< " max-error-per-bone t=" << worst.translation << " r=" << degrees(worst.rotation) << "deg s=" << worst.scale;
+		_Report("clip compress", boneCount, compressMs, note.str().c_str());
+	}
+
+	//同じクリップを元のままと圧縮したもので再生し、1関節あたりの時間を比べる
+	const uint32 characterCount = 500;
+	SceneGraph scene;
+	std::vector<uint32> targetNodes(characterCount * boneCount);
+	for (uint32 idx=0; idx<characterCount * boneCount; ++idx)
+	{
+		uint32 bone = idx % boneCount;
+		targetNodes[idx] = scene.AddNode((bone == 0) ? SceneGraph::InvalidNode : targetNodes[idx - bone], vec3(0.0f), quat(1.0f, 0.0f, 0.0f, 0.0f), vec3(1.0f));
+	}
+	const uint32 trackCount = clip.GetTrackCount();
+	const float32 duration = clip.GetDuration();
+	const uint32 bones = characterCount * boneCount;
+	const uint32 iterations = 2000000 / bones;
+	AnimationPose pose;
+	for (bool useCompressed : {false, true})
+	{
+		std::vector<uint32> cursors(characterCount * trackCount, 0);
+		std::vector<float32> playTimes(characterCount);
+		for (uint32 idx=0; idx<characterCount; ++idx)
+		{
+			playTimes[idx] = duration * float32(idx) / float32(characterCount);
+		}
+		float64 ms = MeasureMs(iterations, [&]() {
+			for (uint32 idx=0; idx<characterCount; ++idx)
+			{
+				playTimes[idx] = fmodf(playTimes[idx] + 1.0f / 60.0f, duration);
+				pose.Reset(boneCount);
+				if (useCompressed)
+				{
+					compressed.Sample(playTimes[idx], &cursors[idx * trackCount], 1.0f, pose);
+				}
+				else
+				{
+					clip.Sample(playTimes[idx], &cursors[idx * trackCount], 1.0f, pose);
+				}
+				pose.Apply(&targetNodes[idx * boneCount], scene);
+			}
+		});
+
+		std::stringstream note;
+		note << "characters=" << characterCount << " " << (useCompressed ? "compressed" : "raw") << " " << (ms * 1.0e6 / bones) << "ns/bone";
+		_Report("clip compress sampling", bones, ms, note.str().c_str());
+	}
+}
+
+void Benchmark::
+_RunMorphTargets(void)
+{
+	//VRMの顔程度(1万頂点・50ブレンドシェイプ)で、各ターゲットは頂点の5%だけを動かす
+	const uint32 vertexCount = 10000;
+	const uint32 targetCount = 50;
+	std::mt19937 rng(targetCount);
+	std::uniform_real_distribution<float32> unit(-1.0f, 1.0f);
+	std::vector<vec3> vertices(vertexCount * 2);	//位置・法線
+	for (auto& v : vertices)
+	{
+		v = vec3(unit(rng), unit(rng), unit(rng));
+	}
+	MorphTargets morphs;
+	for (uint32 target=0; target<targetCount; ++target)
+	{
+		std::vector<vec3> positions(vertexCount, vec3(0.0f)), normals(vertexCount, vec3(0.0f));
+		uint32 first = rng() % (vertexCount - vertexCount / 20);
+		for (uint32 idx=first; idx<first + vertexCount / 20; ++idx)
+		{
+			positions[idx] = vec3(unit(rng), unit(rng), unit(rng)) * 0.01f;
+			normals[idx] = vec3(unit(rng), unit(rng), unit(rng)) * 0.1f;
+		}
+		morphs.AddTarget(target, 0, vertexCount, positions.data(), normals.data());
+	}
+	morphs.Build(vertices.data(), sizeof(vec3) * 2);
+	std::vector<vec4> outPositions(morphs.Size()), outNormals(morphs.Size());
+
+	//表情を3つ重ねた場合と全ターゲットを動かした場合 ウェイトが0なら評価自体を省く
+	for (uint32 activeCount : {0u, 3u, targetCount})
+	{
+		std::vector<float32> weights(targetCount, 0.0f);
+		for (uint32 idx=0; idx<activeCount; ++idx)
+		{
+			weights[(idx * 7) % targetCount] = 0.5f;
+		}
+		float64 ms = MeasureMs(2000, [&]() {
+			if (!MorphTargets::IsZero(weights.data(), targetCount))
+			{
+				morphs.Evaluate(weights.data(), outPositions.data(), outNormals.data());
+			}
+		});
+
+		std::stringstream note;
+		note << "targets=" << targetCount << " active=" << activeCount << " vertices=" << vertexCount
+			<< " deltas=" << morphs.GetDeltaCount() << " " << (ms * 1.0e6 / morphs.Size()) << "ns/vertex";
+		_Report("morph targets cpu", morphs.Size(), ms, note.str().c_str());
+	}
+}
+
+void Benchmark::
+_Report(const char* name, uint32 objectCount, float64 msPerRun, const char* note)
+{
+	std::stringstream ss;
+	ss << "[Benchmark] " << name << " n=" << objectCount
+		<< " " << msPerRun << "ms"
+		<< " " << (msPerRun > 0.0 ? objectCount / msPerRun : 0.0) << "obj/ms";
+	if (note != nullptr && note[0] != '\0')
+	{
+		ss << " " << note;
+	}
+	ss << "\n";
+	OutputDebugStringA(ss.str().c_str());
+}
@@ -0,0 +1,32 @@
+﻿#pragma once
+
+
+//コマンドライン引数 -bench で起動したときに実行する計測
+//結果はOutputDebugStringへ書き出す
+class Benchmark
+{
+public:
+	static void
+	Run(void);
+
+private:
+	static void
+	_RunJobSystem(void);
+	static void
+	_RunFrustumCulling(void);
+	static void
+	_RunCrowdUpdate(void);
+	static void
+	_RunSceneGraphUpdate(void);
+	static void
+	_RunSkinning(void);
+	static void
+	_RunAnimationSampling(void);
+	static void
+	_RunClipCompression(void);
+	static void
+	_RunMorphTargets(void);
+
+	static void
+	_Report(const char* name, uint32 objectCount, float64 msPerRun, const char* note);
+};
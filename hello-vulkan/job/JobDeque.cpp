@@ -0,0 +1,77 @@
+﻿#include "pch.h"
+#include "JobDeque.h"
+
+
+JobDeque::
+JobDeque(uint32 capacity)
+: m_slots(new Job[capacity])
+, m_mask(int64(capacity) - 1)
+, m_top(0)
+, m_padding()
+, m_bottom(0)
+{
+}
+
+bool JobDeque::
+Push(const Job& job)
+{
+	int64 b = m_bottom.load(std::memory_order_relaxed);
+	int64 t = m_top.load(std::memory_order_acquire);
+	if (b - t > m_mask)
+	{
+		return false;
+	}
+	m_slots[b & m_mask] = job;
+	//中身を書いてから末尾を進める
+	m_bottom.store(b + 1, std::memory_order_release);
+	return true;
+}
+
+bool JobDeque::
+Pop(Job& job)
+{
+	//先に末尾を縮めて盗む側に見せてから先頭を読む
+	int64 b = m_bottom.load(std::memory_order_relaxed) - 1;
+	m_bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 t = m_top.load(std::memory_order_relaxed);
+	if (t > b)
+	{
+		//空だった
+		m_bottom.store(b + 1, std::memory_order_relaxed);
+		return false;
+	}
+	job = m_slots[b & m_mask];
+	bool taken = true;
+	if (t == b)
+	{
+		//最後の1個は盗む側と先頭を取り合う
+		taken = m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+		m_bottom.store(b + 1, std::memory_order_relaxed);
+	}
+	return taken;
+}
+
+bool JobDeque::
+Steal(Job& job)
+{
+	int64 t = m_top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	int64 b = m_bottom.load(std::memory_order_acquire);
+	if (t >= b)
+	{
+		return false;
+	}
+	//先頭を進めた後は持ち主が枠を使い回せるので、取り合う前に写しておく
+	//写している間に上書きされた場合は先頭も進んでいるので、下の比較で捨てられる
+	job = m_slots[t & m_mask];
+	return m_top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+}
+
+uint32 JobDeque::
+Size(void) const
+{
+	int64 b = m_bottom.load(std::memory_order_relaxed);
+	int64 t = m_top.load(std::memory_order_relaxed);
+	return (b > t) ? uint32(b - t) : 0;
+}
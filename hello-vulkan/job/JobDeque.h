@@ -0,0 +1,39 @@
+﻿#pragma once
+
+#include <atomic>
+#include <memory>
+#include "job/JobSystem.h"
+
+
+//Chase-Levのワークスティーリング用の両端キュー(固定長)
+//持ち主のスレッドだけが末尾へPush・末尾からPopし、他のスレッドは先頭からStealする
+//持ち主は後に積んだものから、盗む側は古いものから取るので、大きく分けた仕事ほど盗まれやすい
+//ジョブは値で持つ 枠は取り出されてから1周するまで上書きされないので、積んだままのジョブが古くなっても壊れない
+class JobDeque
+{
+public:
+	//capacityは2のべき乗
+	explicit JobDeque(uint32 capacity);
+
+	//持ち主のみ 満杯ならfalse
+	bool
+	Push(const Job& job);
+	//持ち主のみ 空ならfalse
+	bool
+	Pop(Job& job);
+	//どのスレッドからでもよい 空か他と取り合って負けたらfalse
+	bool
+	Steal(Job& job);
+
+	//おおよその数
+	uint32
+	Size(void) const;
+
+private:
+	std::unique_ptr<Job[]> m_slots;
+	int64 m_mask;
+	std::atomic<int64> m_top;
+	//持ち主と盗む側で別々に書き換えるので、キャッシュラインを分ける
+	uint8 m_padding[64 - sizeof(std::atomic<int64>)];
+	std::atomic<int64> m_bottom;
+};
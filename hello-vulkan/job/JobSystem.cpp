@@ -0,0 +1,296 @@
+﻿#include "pch.h"
+#include "JobSystem.h"
+#include "job/JobDeque.h"
+
+
+namespace
+{
+	//スレッドごとのキューの長さ(あふれたジョブはその場で実行する)
+	const uint32 DequeCapacity = 4096;
+	//仕事が見つからないとき眠るまでに譲る回数
+	const uint32 IdleSpins = 64;
+
+	thread_local const JobSystem* t_system = nullptr;
+	thread_local uint32 t_threadIndex = 0;
+
+	//ParallelForの範囲を分けるジョブの共有データ
+	struct RangeData
+	{
+		JobSystem* system;
+		const JobSystem::RangeFunc* fn;
+		uint32 chunkSize;
+		JobCounter* counter;
+	};
+
+	void
+	RunRange(void* data, uint32 begin, uint32 end)
+	{
+		//チャンク単位で半分に分けて後ろ半分を積み、前半を自分で続ける
+		auto& range = *reinterpret_cast<RangeData*>(data);
+		while (end - begin > range.chunkSize)
+		{
+			uint32 chunks = (end - begin + range.chunkSize - 1) / range.chunkSize;
+			uint32 mid = begin + (chunks / 2) * range.chunkSize;
+			range.system->Spawn(Job{ &RunRange, data, mid, end, range.counter });
+			end = mid;
+		}
+		(*range.fn)(begin, end);
+	}
+}
+
+
+JobSystem::
+JobSystem()
+: m_workers()
+, m_slots()
+, m_mutex()
+, m_wakeCv()
+, m_stop(false)
+, m_queuedJobs(0)
+, m_sleepingWorkers(0)
+, m_backgroundJobs()
+, m_backgroundCount(0)
+{
+}
+
+JobSystem::
+~JobSystem()
+{
+	Stop();
+}
+
+void JobSystem::
+Start(uint32 workerCount)
+{
+	Stop();
+	m_stop = false;
+	m_slots.resize(workerCount + 1);
+	for (uint32 idx=0; idx<=workerCount; ++idx)
+	{
+		m_slots[idx].reset(new ThreadSlot{ std::unique_ptr<JobDeque>(new JobDeque(DequeCapacity)), idx * 2654435761u + 1 });
+	}
+	m_workers.reserve(workerCount);
+	for (uint32 idx=0; idx<workerCount; ++idx)
+	{
+		m_workers.emplace_back(&JobSystem::_WorkerMain, this, idx + 1);
+	}
+}
+
+void JobSystem::
+Stop(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wakeCv.notify_all();
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+	m_workers.clear();
+	m_slots.clear();
+	m_queuedJobs.store(0, std::memory_order_relaxed);
+	//実行されなかった背景の仕事は捨てる(待っている側は止める前に終わりを待っておく)
+	m_backgroundJobs.clear();
+	m_backgroundCount.store(0, std::memory_order_relaxed);
+}
+
+void JobSystem::
+Spawn(const Job& job)
+{
+	if (job.counter != nullptr)
+	{
+		job.counter->m_value.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (m_slots.empty())
+	{
+		_Execute(job);
+		return;
+	}
+
+	//キューへ入れる前に数えておけば、取った側が引いても負にならない
+	m_queuedJobs.fetch_add(1, std::memory_order_seq_cst);
+	if (!m_slots[_GetSlot()]->deque->Push(job))
+	{
+		m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+		_Execute(job);
+		return;
+	}
+
+	//眠っているワーカーがいれば1つ起こす
+	//ワーカーは眠る前に数を増やしてからm_queuedJobsを見るので、どちらかが必ず相手に気付く
+	if (m_sleepingWorkers.load(std::memory_order_seq_cst) > 0)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_wakeCv.notify_one();
+	}
+}
+
+void JobSystem::
+Wait(JobCounter& counter)
+{
+	const uint32 slot = _GetSlot();
+	Job job;
+	while (!counter.IsDone())
+	{
+		if (!m_slots.empty() && _FindJob(slot, job))
+		{
+			_Execute(job);
+		}
+		else
+		{
+			//残りは他のスレッドが実行中
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::
+SpawnBackground(const Job& job)
+{
+	if (job.counter != nullptr)
+	{
+		job.counter->m_value.fetch_add(1, std::memory_order_relaxed);
+	}
+	if (m_workers.empty())
+	{
+		_Execute(job);
+		return;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_backgroundJobs.push_back(job);
+		m_backgroundCount.fetch_add(1, std::memory_order_release);
+	}
+	m_wakeCv.notify_one();
+}
+
+void JobSystem::
+ParallelFor(uint32 count, uint32 chunkSize, const RangeFunc& fn)
+{
+	if (count == 0)
+	{
+		return;
+	}
+	chunkSize = (std::max)(chunkSize, 1u);
+	//1チャンクに収まるかワーカーがいなければその場で処理する
+	if (count <= chunkSize || m_workers.empty())
+	{
+		fn(0, count);
+		return;
+	}
+
+	JobCounter counter;
+	RangeData data{ this, &fn, chunkSize, &counter };
+	RunRange(&data, 0, count);
+	Wait(counter);
+}
+
+uint32 JobSystem::
+GetHardwareThreadCount(void)
+{
+	return (std::max)(std::thread::hardware_concurrency(), 1u);
+}
+
+uint32 JobSystem::
+GetThreadIndex(void)
+{
+	return t_threadIndex;
+}
+
+void JobSystem::
+_WorkerMain(uint32 threadIndex)
+{
+	t_system = this;
+	t_threadIndex = threadIndex;
+	uint32 idle = 0;
+	Job job;
+	for (;;)
+	{
+		//フレームの仕事を先に片付け、無ければ背景の仕事を取る
+		if (_FindJob(threadIndex, job) || _PopBackground(job))
+		{
+			_Execute(job);
+			idle = 0;
+			continue;
+		}
+		if (++idle < IdleSpins)
+		{
+			std::this_thread::yield();
+			continue;
+		}
+
+		//しばらく見つからなければ、積まれるか止めるまで眠る
+		idle = 0;
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+		m_wakeCv.wait(lock, [this]() { return m_stop || m_queuedJobs.load(std::memory_order_seq_cst) > 0 || !m_backgroundJobs.empty(); });
+		m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+		if (m_stop)
+		{
+			return;
+		}
+	}
+}
+
+uint32 JobSystem::
+_GetSlot(void) const
+{
+	return (t_system == this) ? t_threadIndex : 0;
+}
+
+bool JobSystem::
+_FindJob(uint32 slotIndex, Job& job)
+{
+	auto& slot = *m_slots[slotIndex];
+	bool found = slot.deque->Pop(job);
+	if (!found)
+	{
+		//盗む相手は乱数で選んだところから順に見る
+		const uint32 slotCount = uint32(m_slots.size());
+		slot.random = slot.random * 1664525u + 1013904223u;
+		uint32 start = (slot.random >> 16) % slotCount;
+		for (uint32 idx=0; idx<slotCount && !found; ++idx)
+		{
+			uint32 victim = (start + idx) % slotCount;
+			if (victim != slotIndex)
+			{
+				found = m_slots[victim]->deque->Steal(job);
+			}
+		}
+	}
+	if (found)
+	{
+		m_queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+	}
+	return found;
+}
+
+bool JobSystem::
+_PopBackground(Job& job)
+{
+	if (m_backgroundCount.load(std::memory_order_acquire) == 0)
+	{
+		return false;
+	}
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_backgroundJobs.empty())
+	{
+		return false;
+	}
+	job = m_backgroundJobs.front();
+	m_backgroundJobs.pop_front();
+	m_backgroundCount.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+void JobSystem::
+_Execute(const Job& job)
+{
+	job.func(job.data, job.begin, job.end);
+	if (job.counter != nullptr)
+	{
+		job.counter->m_value.fetch_sub(1, std::memory_order_release);
+	}
+}
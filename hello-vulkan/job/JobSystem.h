@@ -0,0 +1,121 @@
+﻿#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class JobCounter;
+class JobDeque;
+
+
+//1つの仕事 func(data, begin, end)を呼ぶ
+struct Job
+{
+	void (*func)(void* data, uint32 begin, uint32 end);
+	void* data;
+	uint32 begin;
+	uint32 end;
+	JobCounter* counter;	//終わったら1減らす(nullptrでもよい)
+};
+
+//フォーク・ジョインのカウンター
+//Spawnのたびに1増え、そのジョブが終わると1減る JobSystem::Waitで0になるまで待つ
+class JobCounter
+{
+public:
+	JobCounter() : m_value(0) {}
+
+	bool
+	IsDone(void) const { return m_value.load(std::memory_order_acquire) == 0; }
+
+private:
+	friend class JobSystem;
+	std::atomic<uint32> m_value;
+};
+
+
+//ワークスティーリングのジョブシステム
+//スレッドごと(呼び出し側の0番とワーカー)にChase-Levの両端キューを持ち、自分のキューが空なら他から盗む
+//ワーカー以外から使えるのは1スレッド(メインスレッド)のみで、そのスレッドは0番のキューを使う
+class JobSystem
+{
+public:
+	//fn(begin, end)で[begin, end)を処理する
+	typedef std::function<void(uint32, uint32)> RangeFunc;
+
+public:
+	JobSystem();
+	~JobSystem();
+
+	//workerCount個のワーカーを起動する(0なら呼び出し側のみで処理する)
+	void
+	Start(uint32 workerCount);
+	void
+	Stop(void);
+	//呼び出し側を含めて同時に動くスレッド数
+	uint32
+	GetThreadCount(void) const { return uint32(m_workers.size()) + 1; }
+
+	//今のスレッドのキューへ積む(キューが満杯か起動前ならその場で実行する)
+	void
+	Spawn(const Job& job);
+	//counterが0になるまで、自分のキューや他のキューのジョブを実行しながら待つ
+	void
+	Wait(JobCounter& counter);
+	//ワーカーだけが取る長い仕事(ファイル読み込みなど)を積む
+	//呼び出し側のWaitでは実行しないので、フレーム中のParallelForが巻き込まれて止まることがない
+	//ワーカーがいなければその場で実行する
+	void
+	SpawnBackground(const Job& job);
+
+	//[0, count)をchunkSize個ずつに分けて並列に処理し、すべて終わるまで戻らない
+	//範囲を半分ずつに分けて後ろ半分を積むので、空いたスレッドが大きな塊から盗んでいく
+	void
+	ParallelFor(uint32 count, uint32 chunkSize, const RangeFunc& fn);
+
+public:
+	static uint32
+	GetHardwareThreadCount(void);
+	//処理中のスレッドの番号(ワーカーは1～ワーカー数、それ以外のスレッドは0)
+	//スレッドごとの資源をParallelForの中で使い分けるときに使う
+	static uint32
+	GetThreadIndex(void);
+
+private:
+	//スレッドごとの持ち物
+	struct ThreadSlot
+	{
+		std::unique_ptr<JobDeque> deque;
+		uint32 random;				//盗む相手を選ぶ乱数
+	};
+
+private:
+	void
+	_WorkerMain(uint32 threadIndex);
+	//このJobSystemでの今のスレッドの番号
+	uint32
+	_GetSlot(void) const;
+	//自分のキューから取り、空なら他から盗む
+	bool
+	_FindJob(uint32 slot, Job& job);
+	bool
+	_PopBackground(Job& job);
+	void
+	_Execute(const Job& job);
+
+private:
+	std::vector<std::thread> m_workers;
+	std::vector<std::unique_ptr<ThreadSlot>> m_slots;
+	std::mutex m_mutex;
+	std::condition_variable m_wakeCv;	//眠っているワーカーを起こす
+	bool m_stop;
+	std::atomic<int32> m_queuedJobs;	//キューにあるジョブ数(多めに数えることはあっても少なくはならない)
+	std::atomic<uint32> m_sleepingWorkers;
+	std::deque<Job> m_backgroundJobs;		//m_mutexで守る
+	std::atomic<uint32> m_backgroundCount;	//ロックせずに空か調べる
+};
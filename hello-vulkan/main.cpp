@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "vulkan/ModelApp.h"
+#include "bench/Benchmark.h"
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow)
 {
@@ -7,6 +8,13 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 	const int WindowHeight = 720;
 	const char* AppTitle = "Hello Vulkan";
 
+	//v[h
+	if (strstr(lpCmdLine, "-bench") != nullptr)
+	{
+		Benchmark::Run();
+		return 0;
+	}
+
 	glfwInit();
 	glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
 	glfwWindowHint(GLFW_RESIZABLE, 0);
@@ -15,6 +23,32 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine
 
 	// Vulkan
 	ModelApp theApp;
+	//QO`̌vV[(-crowd l)
+	if (auto crowdArg = strstr(lpCmdLine, "-crowd"))
+	{
+		theApp.SetCrowdSize(uint32(atoi(crowdArg + strlen("-crowd"))));
+	}
+	//oChX̃eNX`zgȂ(}eAƂ̃fBXNv^ZbgƔׂ)
+	if (strstr(lpCmdLine, "-nobindless") != nullptr)
+	{
+		theApp.SetBindlessEnabled(false);
+	}
+	//bṼJOŏRs[gōs
+	if (strstr(lpCmdLine, "-gpucull") != nullptr)
+	{
+		theApp.SetGpuCullingEnabled(true);
+	}
+	//LL[œւ郂f(-model t@C ׂ st@C̑΃pX)
+	for (auto modelArg = strstr(lpCmdLine, "-model"); modelArg != nullptr; modelArg = strstr(modelArg + 1, "-model"))
+	{
+		char fileName[_MAX_PATH];
+		wchar wideName[_MAX_PATH];
+		if (sscanf_s(modelArg + strlen("-model"), "%s", fileName, unsigned(_countof(fileName))) == 1
+			&& MultiByteToWideChar(CP_ACP, 0, fileName, -1, wideName, _MAX_PATH) > 0)
+		{
+			theApp.AddModelFile(wideName);
+		}
+	}
 	theApp.initialize(window, AppTitle);
 	while (glfwWindowShouldClose(window) == GLFW_FALSE)
 	{
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "GLTFReader.h"
+#include "MappedFileStream.h"
 
 GLTFReader::
 GLTFReader(std::experimental::filesystem::path pathBase)
@@ -16,11 +17,12 @@ std::shared_ptr<std::istream> GLTFReader::
 GetInputStream(const std::string& filename) const
 {
 	auto streamPath = m_pathBase / std::experimental::filesystem::u8path(filename);
-	/*std::wstringbuf strBuf(streamPath);
-	auto stream = std::make_shared<std::wifstream>(&strBuf, std::ios_base::binary);
-	if (!stream)
+
+	//}bvŊJȂꍇ͒ʏ̃t@CXg[œǂ
+	auto mapped = std::make_shared<MappedFileStream>(streamPath);
+	if (mapped->isOpen())
 	{
-	}*/
-	auto foge = std::make_shared<std::ifstream>(streamPath, std::ios_base::binary);
-	return foge;
+		return mapped;
+	}
+	return std::make_shared<std::ifstream>(streamPath, std::ios_base::binary);
 }
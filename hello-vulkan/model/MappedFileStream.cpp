@@ -0,0 +1,162 @@
+﻿#include "pch.h"
+#include "MappedFileStream.h"
+
+
+MappedFileBuf::
+MappedFileBuf()
+: std::streambuf()
+, m_file(INVALID_HANDLE_VALUE)
+, m_mapping(nullptr)
+, m_view(nullptr)
+, m_size(0)
+{
+}
+
+MappedFileBuf::
+~MappedFileBuf()
+{
+	close();
+}
+
+bool MappedFileBuf::
+open(const std::experimental::filesystem::path& path)
+{
+	close();
+
+	//先頭から順に読まれるのでシーケンシャルアクセスをヒントとして渡す
+	m_file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (m_file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize{};
+	if (!GetFileSizeEx(m_file, &fileSize) || fileSize.QuadPart == 0)
+	{
+		//空ファイルはマップできない
+		close();
+		return false;
+	}
+	m_size = uint64(fileSize.QuadPart);
+
+	m_mapping = CreateFileMappingW(m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (m_mapping == nullptr)
+	{
+		close();
+		return false;
+	}
+	m_view = static_cast<char*>(MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0));
+	if (m_view == nullptr)
+	{
+		close();
+		return false;
+	}
+
+	//ページフォルトを待たずにページキャッシュから先読みさせる
+	WIN32_MEMORY_RANGE_ENTRY range{};
+	range.VirtualAddress = m_view;
+	range.NumberOfBytes = SIZE_T(m_size);
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+
+	setg(m_view, m_view, m_view + m_size);
+	return true;
+}
+
+void MappedFileBuf::
+close(void)
+{
+	setg(nullptr, nullptr, nullptr);
+	if (m_view != nullptr)
+	{
+		UnmapViewOfFile(m_view);
+		m_view = nullptr;
+	}
+	if (m_mapping != nullptr)
+	{
+		CloseHandle(m_mapping);
+		m_mapping = nullptr;
+	}
+	if (m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+	m_size = 0;
+}
+
+MappedFileBuf::pos_type MappedFileBuf::
+seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which)
+{
+	if ((which & std::ios_base::in) == 0 || m_view == nullptr)
+	{
+		return pos_type(off_type(-1));
+	}
+
+	off_type base = 0;
+	switch (dir)
+	{
+	case std::ios_base::beg:
+		base = 0;
+		break;
+	case std::ios_base::cur:
+		base = off_type(gptr() - eback());
+		break;
+	case std::ios_base::end:
+		base = off_type(m_size);
+		break;
+	default:
+		return pos_type(off_type(-1));
+	}
+
+	off_type newPos = base + off;
+	if (newPos < 0 || uint64(newPos) > m_size)
+	{
+		return pos_type(off_type(-1));
+	}
+	setg(eback(), eback() + newPos, egptr());
+	return pos_type(newPos);
+}
+
+MappedFileBuf::pos_type MappedFileBuf::
+seekpos(pos_type pos, std::ios_base::openmode which)
+{
+	return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+
+std::streamsize MappedFileBuf::
+xsgetn(char_type* dst, std::streamsize count)
+{
+	//ビューから直接コピーする(1文字ずつのunderflowを経由しない)
+	auto available = std::streamsize(egptr() - gptr());
+	auto size = (std::min)(count, available);
+	if (size > 0)
+	{
+		memcpy(dst, gptr(), size_t(size));
+		setg(eback(), gptr() + size, egptr());
+	}
+	return size;
+}
+
+std::streamsize MappedFileBuf::
+showmanyc(void)
+{
+	auto available = std::streamsize(egptr() - gptr());
+	return available > 0 ? available : -1;
+}
+
+
+MappedFileStream::
+MappedFileStream(const std::experimental::filesystem::path& path)
+: std::istream(&m_buf)
+, m_buf()
+{
+	if (!m_buf.open(path))
+	{
+		setstate(std::ios_base::failbit);
+	}
+}
+
+MappedFileStream::
+~MappedFileStream()
+{
+}
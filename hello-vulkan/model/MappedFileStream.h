@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include <experimental/filesystem>
+#include <istream>
+#include <streambuf>
+
+
+//ファイル全体をメモリマップし、ビューを直接get領域として公開するstreambuf
+class MappedFileBuf : public std::streambuf
+{
+public:
+	MappedFileBuf();
+	~MappedFileBuf();
+
+	MappedFileBuf(const MappedFileBuf&) = delete;
+	MappedFileBuf& operator=(const MappedFileBuf&) = delete;
+
+
+public:
+	bool
+	open(const std::experimental::filesystem::path& path);
+	void
+	close(void);
+	bool
+	isOpen(void) const { return m_view != nullptr; }
+
+
+protected:
+	pos_type
+	seekoff(off_type off, std::ios_base::seekdir dir, std::ios_base::openmode which) override;
+	pos_type
+	seekpos(pos_type pos, std::ios_base::openmode which) override;
+	std::streamsize
+	xsgetn(char_type* dst, std::streamsize count) override;
+	std::streamsize
+	showmanyc(void) override;
+
+
+private:
+	HANDLE m_file;
+	HANDLE m_mapping;
+	char* m_view;
+	uint64 m_size;
+};
+
+
+//MappedFileBufを所有するistream
+class MappedFileStream : public std::istream
+{
+public:
+	explicit MappedFileStream(const std::experimental::filesystem::path& path);
+	~MappedFileStream();
+
+
+public:
+	bool
+	isOpen(void) const { return m_buf.isOpen(); }
+
+
+private:
+	MappedFileBuf m_buf;
+};
@@ -0,0 +1,288 @@
+﻿#include "pch.h"
+#include "MeshSimplifier.h"
+#include <unordered_map>
+
+using namespace glm;
+
+
+namespace
+{
+	//対称4x4行列の上三角10要素
+	struct Quadric
+	{
+		float64 a00, a01, a02, a03;
+		float64 a11, a12, a13;
+		float64 a22, a23;
+		float64 a33;
+
+		void
+		AddPlane(const dvec3& n, float64 d)
+		{
+			a00 += n.x * n.x; a01 += n.x * n.y; a02 += n.x * n.z; a03 += n.x * d;
+			a11 += n.y * n.y; a12 += n.y * n.z; a13 += n.y * d;
+			a22 += n.z * n.z; a23 += n.z * d;
+			a33 += d * d;
+		}
+		void
+		Add(const Quadric& q)
+		{
+			a00 += q.a00; a01 += q.a01; a02 += q.a02; a03 += q.a03;
+			a11 += q.a11; a12 += q.a12; a13 += q.a13;
+			a22 += q.a22; a23 += q.a23;
+			a33 += q.a33;
+		}
+		float64
+		Error(const dvec3& p) const
+		{
+			float64 e =
+				a00 * p.x * p.x + 2.0 * a01 * p.x * p.y + 2.0 * a02 * p.x * p.z + 2.0 * a03 * p.x +
+				a11 * p.y * p.y + 2.0 * a12 * p.y * p.z + 2.0 * a13 * p.y +
+				a22 * p.z * p.z + 2.0 * a23 * p.z +
+				a33;
+			return (std::max)(e, 0.0);
+		}
+	};
+
+	struct Collapse
+	{
+		uint32 from;
+		uint32 to;
+		float64 cost;
+	};
+
+	inline uint64
+	EdgeKey(uint32 a, uint32 b)
+	{
+		return (a < b) ? (uint64(a) << 32) | b : (uint64(b) << 32) | a;
+	}
+}
+
+
+float32 MeshSimplifier::
+Simplify(const float32* positions, uint32 strideBytes, uint32 vertexCount, const std::vector<uint32>& indices, uint32 targetIndexCount, float32 maxError, std::vector<uint32>& result)
+{
+	result = indices;
+	if (indices.size() <= targetIndexCount || vertexCount == 0)
+	{
+		return 0.0f;
+	}
+
+	std::vector<dvec3> points(vertexCount);
+	dvec3 minPos(DBL_MAX), maxPos(-DBL_MAX);
+	for (uint32 idx=0; idx<vertexCount; ++idx)
+	{
+		auto p = reinterpret_cast<const float32*>(reinterpret_cast<const uint8*>(positions) + size_t(idx) * strideBytes);
+		points[idx] = dvec3(p[0], p[1], p[2]);
+		minPos = min(minPos, points[idx]);
+		maxPos = max(maxPos, points[idx]);
+	}
+	//誤差はメッシュの大きさに対する比率で扱う
+	float64 extent = length(maxPos - minPos);
+	if (extent <= 0.0)
+	{
+		return 0.0f;
+	}
+	float64 maxCost = (float64(maxError) * extent) * (float64(maxError) * extent);
+
+	//各頂点に隣接面の平面二次誤差を集める
+	std::vector<Quadric> quadrics(vertexCount, Quadric{});
+	for (size_t idx=0; idx+2<result.size(); idx+=3)
+	{
+		const auto& p0 = points[result[idx + 0]];
+		const auto& p1 = points[result[idx + 1]];
+		const auto& p2 = points[result[idx + 2]];
+		auto n = cross(p1 - p0, p2 - p0);
+		float64 len = length(n);
+		if (len <= 0.0)
+		{
+			continue;
+		}
+		n /= len;
+		float64 d = -dot(n, p0);
+		for (uint32 k=0; k<3; ++k)
+		{
+			quadrics[result[idx + k]].AddPlane(n, d);
+		}
+	}
+
+	//境界辺(UVシームを含む)上の頂点は形が崩れるので固定する
+	std::vector<uint8> locked(vertexCount, 0);
+	{
+		std::unordered_map<uint64, uint32> edgeUse;
+		edgeUse.reserve(result.size());
+		for (size_t idx=0; idx+2<result.size(); idx+=3)
+		{
+			for (uint32 k=0; k<3; ++k)
+			{
+				++edgeUse[EdgeKey(result[idx + k], result[idx + (k + 1) % 3])];
+			}
+		}
+		for (const auto& e : edgeUse)
+		{
+			if (e.second == 1)
+			{
+				locked[uint32(e.first >> 32)] = 1;
+				locked[uint32(e.first & 0xffffffffu)] = 1;
+			}
+		}
+	}
+
+	float64 resultCost = 0.0;
+	std::vector<uint32> remap(vertexCount);
+	std::vector<uint8> touched(vertexCount);
+	std::vector<uint32> adjOffset;
+	std::vector<uint32> adjTris;
+	std::vector<Collapse> collapses;
+	std::unordered_map<uint64, uint32> edgeSeen;
+
+	//1パスごとに安い辺から独立に縮退させる
+	const uint32 MaxPasses = 32;
+	for (uint32 pass=0; pass<MaxPasses && result.size() > targetIndexCount; ++pass)
+	{
+		const uint32 triCount = uint32(result.size() / 3);
+
+		//頂点→三角形の隣接
+		adjOffset.assign(vertexCount + 1, 0);
+		for (auto v : result)
+		{
+			++adjOffset[v + 1];
+		}
+		for (uint32 idx=0; idx<vertexCount; ++idx)
+		{
+			adjOffset[idx + 1] += adjOffset[idx];
+		}
+		adjTris.resize(result.size());
+		{
+			std::vector<uint32> cursor(adjOffset.begin(), adjOffset.end() - 1);
+			for (uint32 tri=0; tri<triCount; ++tri)
+			{
+				for (uint32 k=0; k<3; ++k)
+				{
+					adjTris[cursor[result[tri * 3 + k]]++] = tri;
+				}
+			}
+		}
+
+		//辺ごとに安い方向の縮退を候補にする
+		collapses.clear();
+		edgeSeen.clear();
+		for (uint32 tri=0; tri<triCount; ++tri)
+		{
+			for (uint32 k=0; k<3; ++k)
+			{
+				uint32 a = result[tri * 3 + k];
+				uint32 b = result[tri * 3 + (k + 1) % 3];
+				if (!edgeSeen.emplace(EdgeKey(a, b), 0).second)
+				{
+					continue;
+				}
+				Quadric q = quadrics[a];
+				q.Add(quadrics[b]);
+				Collapse best{ ~0u, ~0u, DBL_MAX };
+				if (!locked[a])
+				{
+					best = Collapse{ a, b, q.Error(points[b]) };
+				}
+				if (!locked[b])
+				{
+					float64 cost = q.Error(points[a]);
+					if (cost < best.cost)
+					{
+						best = Collapse{ b, a, cost };
+					}
+				}
+				if (best.from != ~0u && best.cost <= maxCost)
+				{
+					collapses.push_back(best);
+				}
+			}
+		}
+		if (collapses.empty())
+		{
+			break;
+		}
+		std::sort(collapses.begin(), collapses.end(), [](const Collapse& l, const Collapse& r) { return l.cost < r.cost; });
+
+		for (uint32 idx=0; idx<vertexCount; ++idx)
+		{
+			remap[idx] = idx;
+		}
+		std::fill(touched.begin(), touched.end(), uint8(0));
+
+		//1回の縮退でおよそ2枚の三角形が消える
+		uint32 removeGoal = (uint32(result.size()) - targetIndexCount) / 3;
+		uint32 removed = 0;
+		uint32 applied = 0;
+		for (const auto& c : collapses)
+		{
+			if (removed >= removeGoal)
+			{
+				break;
+			}
+			if (touched[c.from] || touched[c.to])
+			{
+				continue;
+			}
+
+			//面の裏返りが起きる縮退は行わない
+			bool flipped = false;
+			for (uint32 a=adjOffset[c.from]; a<adjOffset[c.from + 1] && !flipped; ++a)
+			{
+				const uint32* tri = &result[adjTris[a] * 3];
+				if (tri[0] == c.to || tri[1] == c.to || tri[2] == c.to)
+				{
+					continue;
+				}
+				dvec3 p[3], q[3];
+				for (uint32 k=0; k<3; ++k)
+				{
+					p[k] = points[tri[k]];
+					q[k] = (tri[k] == c.from) ? points[c.to] : p[k];
+				}
+				auto n0 = cross(p[1] - p[0], p[2] - p[0]);
+				auto n1 = cross(q[1] - q[0], q[2] - q[0]);
+				flipped = dot(n0, n1) <= 0.0;
+			}
+			if (flipped)
+			{
+				continue;
+			}
+
+			//縮退する頂点に隣接する頂点もこのパスでは動かさない
+			for (uint32 a=adjOffset[c.from]; a<adjOffset[c.from + 1]; ++a)
+			{
+				const uint32* tri = &result[adjTris[a] * 3];
+				touched[tri[0]] = touched[tri[1]] = touched[tri[2]] = 1;
+			}
+			remap[c.from] = c.to;
+			quadrics[c.to].Add(quadrics[c.from]);
+			resultCost = (std::max)(resultCost, c.cost);
+			removed += 2;
+			++applied;
+		}
+		if (applied == 0)
+		{
+			break;
+		}
+
+		//縮退を反映し、潰れた三角形を取り除く
+		size_t write = 0;
+		for (size_t idx=0; idx+2<result.size(); idx+=3)
+		{
+			uint32 v0 = remap[result[idx + 0]];
+			uint32 v1 = remap[result[idx + 1]];
+			uint32 v2 = remap[result[idx + 2]];
+			if (v0 == v1 || v1 == v2 || v2 == v0)
+			{
+				continue;
+			}
+			result[write + 0] = v0;
+			result[write + 1] = v1;
+			result[write + 2] = v2;
+			write += 3;
+		}
+		result.resize(write);
+	}
+
+	return float32(sqrt(resultCost) / extent);
+}
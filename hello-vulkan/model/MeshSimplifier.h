@@ -0,0 +1,15 @@
+﻿#pragma once
+
+#include <vector>
+
+
+//Quadric Error Metricsによる辺縮退でインデックス列を簡略化する
+//頂点は新規に作らず既存の頂点へ縮退させるので、頂点バッファは元のLODと共有できる
+class MeshSimplifier
+{
+public:
+	//targetIndexCount以下になるか、誤差(メッシュ外形に対する比率)がmaxErrorを超えるまで縮退させる
+	//戻り値は実際に生じた誤差の比率
+	static float32
+	Simplify(const float32* positions, uint32 strideBytes, uint32 vertexCount, const std::vector<uint32>& indices, uint32 targetIndexCount, float32 maxError, std::vector<uint32>& result);
+};
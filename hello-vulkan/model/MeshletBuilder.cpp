@@ -0,0 +1,224 @@
+﻿#include "pch.h"
+#include "MeshletBuilder.h"
+
+using namespace glm;
+
+
+static vec3
+LoadPosition(const float32* positions, uint32 strideBytes, uint32 index)
+{
+	auto p = reinterpret_cast<const float32*>(reinterpret_cast<const uint8*>(positions) + size_t(index) * strideBytes);
+	return vec3(p[0], p[1], p[2]);
+}
+
+
+void MeshletBuilder::
+Build(const float32* positions, uint32 strideBytes, uint32 vertexCount, std::vector<uint32>& indices, std::vector<Meshlet>& meshlets)
+{
+	meshlets.clear();
+	const uint32 triCount = uint32(indices.size() / 3);
+	if (triCount == 0)
+	{
+		return;
+	}
+
+	//頂点→三角形の隣接リスト(CSR形式)
+	std::vector<uint32> adjOffset(vertexCount + 1, 0);
+	for (auto v : indices)
+	{
+		++adjOffset[v + 1];
+	}
+	for (uint32 idx=0; idx<vertexCount; ++idx)
+	{
+		adjOffset[idx + 1] += adjOffset[idx];
+	}
+	std::vector<uint32> adjTris(triCount * 3);
+	{
+		std::vector<uint32> cursor(adjOffset.begin(), adjOffset.end() - 1);
+		for (uint32 tri=0; tri<triCount; ++tri)
+		{
+			for (uint32 k=0; k<3; ++k)
+			{
+				adjTris[cursor[indices[tri * 3 + k]]++] = tri;
+			}
+		}
+	}
+
+	//三角形ごとの面法線
+	std::vector<vec3> triNormals(triCount);
+	for (uint32 tri=0; tri<triCount; ++tri)
+	{
+		auto p0 = LoadPosition(positions, strideBytes, indices[tri * 3 + 0]);
+		auto p1 = LoadPosition(positions, strideBytes, indices[tri * 3 + 1]);
+		auto p2 = LoadPosition(positions, strideBytes, indices[tri * 3 + 2]);
+		auto n = cross(p1 - p0, p2 - p0);
+		float32 len = length(n);
+		triNormals[tri] = (len > 0.0f) ? n / len : vec3(0.0f);
+	}
+
+	std::vector<uint8> emitted(triCount, 0);
+	std::vector<uint32> vertexTag(vertexCount, ~0u);
+	std::vector<uint32> candidates;
+	std::vector<uint32> ordered;
+	ordered.reserve(indices.size());
+
+	uint32 seed = 0;
+	for (uint32 meshletId=0; ; ++meshletId)
+	{
+		while (seed < triCount && emitted[seed])
+		{
+			++seed;
+		}
+		if (seed == triCount)
+		{
+			break;
+		}
+
+		Meshlet meshlet{};
+		meshlet.firstIndex = uint32(ordered.size());
+		uint32 meshletVerts = 0;
+		uint32 meshletTris = 0;
+		vec3 normalSum(0.0f);
+		candidates.clear();
+
+		//隣接三角形を貪欲に取り込み、新規頂点が少なく向きの揃ったものを優先する
+		uint32 tri = seed;
+		while (tri != ~0u)
+		{
+			emitted[tri] = 1;
+			for (uint32 k=0; k<3; ++k)
+			{
+				uint32 v = indices[tri * 3 + k];
+				if (vertexTag[v] != meshletId)
+				{
+					vertexTag[v] = meshletId;
+					++meshletVerts;
+					for (uint32 a=adjOffset[v]; a<adjOffset[v + 1]; ++a)
+					{
+						if (!emitted[adjTris[a]])
+						{
+							candidates.push_back(adjTris[a]);
+						}
+					}
+				}
+				ordered.push_back(v);
+			}
+			++meshletTris;
+			normalSum += triNormals[tri];
+			if (meshletTris == MaxTriangles)
+			{
+				break;
+			}
+
+			float32 sumLen = length(normalSum);
+			vec3 axis = (sumLen > 0.0f) ? normalSum / sumLen : vec3(0.0f);
+			float32 bestScore = FLT_MAX;
+			tri = ~0u;
+			for (size_t c=0; c<candidates.size(); )
+			{
+				uint32 cand = candidates[c];
+				if (emitted[cand])
+				{
+					candidates[c] = candidates.back();
+					candidates.pop_back();
+					continue;
+				}
+				uint32 extra = 0;
+				for (uint32 k=0; k<3; ++k)
+				{
+					extra += (vertexTag[indices[cand * 3 + k]] != meshletId) ? 1 : 0;
+				}
+				if (meshletVerts + extra <= MaxVertices)
+				{
+					float32 score = float32(extra) - dot(axis, triNormals[cand]);
+					if (score < bestScore)
+					{
+						bestScore = score;
+						tri = cand;
+					}
+				}
+				++c;
+			}
+		}
+
+		meshlet.indexCount = meshletTris * 3;
+		meshlet.vertexCount = meshletVerts;
+		_ComputeBounds(positions, strideBytes, ordered.data() + meshlet.firstIndex, meshlet.indexCount, meshlet);
+		meshlets.push_back(meshlet);
+	}
+
+	indices.swap(ordered);
+}
+
+void MeshletBuilder::
+_ComputeBounds(const float32* positions, uint32 strideBytes, const uint32* indices, uint32 indexCount, Meshlet& meshlet)
+{
+	//バウンディングスフィア(AABB中心から最遠点までの距離)
+	vec3 minPos(FLT_MAX), maxPos(-FLT_MAX);
+	for (uint32 idx=0; idx<indexCount; ++idx)
+	{
+		auto p = LoadPosition(positions, strideBytes, indices[idx]);
+		minPos = min(minPos, p);
+		maxPos = max(maxPos, p);
+	}
+	vec3 center = (minPos + maxPos) * 0.5f;
+	float32 radiusSq = 0.0f;
+	for (uint32 idx=0; idx<indexCount; ++idx)
+	{
+		auto d = LoadPosition(positions, strideBytes, indices[idx]) - center;
+		radiusSq = (std::max)(radiusSq, dot(d, d));
+	}
+	meshlet.center = center;
+	meshlet.radius = sqrtf(radiusSq);
+
+	//法線コーン
+	meshlet.coneApex = center;
+	meshlet.coneAxis = vec3(0.0f);
+	meshlet.coneCutoff = 1.0f;
+
+	std::vector<vec3> normals;
+	std::vector<vec3> origins;
+	vec3 normalSum(0.0f);
+	for (uint32 idx=0; idx<indexCount; idx+=3)
+	{
+		auto p0 = LoadPosition(positions, strideBytes, indices[idx + 0]);
+		auto p1 = LoadPosition(positions, strideBytes, indices[idx + 1]);
+		auto p2 = LoadPosition(positions, strideBytes, indices[idx + 2]);
+		auto n = cross(p1 - p0, p2 - p0);
+		float32 len = length(n);
+		if (len <= 0.0f)
+		{
+			continue;
+		}
+		normals.push_back(n / len);
+		origins.push_back(p0);
+		normalSum += n / len;
+	}
+	float32 sumLen = length(normalSum);
+	if (normals.empty() || sumLen <= 0.0f)
+	{
+		return;
+	}
+	vec3 axis = normalSum / sumLen;
+	float32 minDot = 1.0f;
+	for (const auto& n : normals)
+	{
+		minDot = (std::min)(minDot, dot(axis, n));
+	}
+	//ほぼ半球以上に広がるコーンはカリングに使えない
+	if (minDot <= 0.1f)
+	{
+		return;
+	}
+
+	//すべての面の平面より後ろに来るようにコーンの頂点を下げる
+	float32 maxT = 0.0f;
+	for (size_t idx=0; idx<normals.size(); ++idx)
+	{
+		float32 t = dot(center - origins[idx], normals[idx]) / dot(axis, normals[idx]);
+		maxT = (std::max)(maxT, t);
+	}
+	meshlet.coneApex = center - axis * maxT;
+	meshlet.coneAxis = axis;
+	meshlet.coneCutoff = sqrtf(1.0f - minDot * minDot);
+}
@@ -0,0 +1,34 @@
+﻿#pragma once
+
+#include <vector>
+
+
+//メッシュを小さなクラスタへ分割した単位
+struct Meshlet
+{
+	uint32 firstIndex;		//並べ替え後のインデックス列での開始位置
+	uint32 indexCount;
+	uint32 vertexCount;
+	glm::vec3 center;		//バウンディングスフィア
+	float32 radius;
+	glm::vec3 coneApex;		//法線コーン(背面カリング用)
+	glm::vec3 coneAxis;
+	float32 coneCutoff;		//1.0以上なら背面カリング不可
+};
+
+
+class MeshletBuilder
+{
+public:
+	static const uint32 MaxVertices = 64;
+	static const uint32 MaxTriangles = 124;
+
+public:
+	//indicesをメッシュレット順に並べ替えて書き戻し、各メッシュレットの範囲と境界を返す
+	static void
+	Build(const float32* positions, uint32 strideBytes, uint32 vertexCount, std::vector<uint32>& indices, std::vector<Meshlet>& meshlets);
+
+private:
+	static void
+	_ComputeBounds(const float32* positions, uint32 strideBytes, const uint32* indices, uint32 indexCount, Meshlet& meshlet);
+};
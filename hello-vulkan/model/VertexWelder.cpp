@@ -0,0 +1,129 @@
+﻿#include "pch.h"
+#include "VertexWelder.h"
+
+
+namespace
+{
+	//量子化した値をそのまま整数にできる範囲(doubleで正確に表せる範囲)
+	const float64 MaxQuantized = 4503599627370496.0;	//2^52
+	//範囲外の値はビット列にこれを足して、量子化した値と重ならないようにする
+	const uint64 RawKeyBase = uint64(1) << 62;
+
+	//比較・ハッシュ用のキー列を頂点ごとに作る
+	inline void
+	MakeKey(const uint8* vertex, uint32 words, float64 invEpsilon, uint64* key)
+	{
+		auto bits = reinterpret_cast<const uint32*>(vertex);
+		auto values = reinterpret_cast<const float32*>(vertex);
+		for (uint32 w=0; w<words; ++w)
+		{
+			float64 quantized = floor(float64(values[w]) * invEpsilon + 0.5);
+			if (invEpsilon > 0.0 && quantized > -MaxQuantized && quantized < MaxQuantized)
+			{
+				key[w] = uint64(int64(quantized));
+			}
+			else
+			{
+				//epsilonが0か、大きすぎる値・NaNはビット単位で比べる
+				key[w] = RawKeyBase + bits[w];
+			}
+		}
+	}
+
+	inline uint32
+	HashKey(const uint64* key, uint32 words)
+	{
+		//FNV-1a
+		uint64 h = 14695981039346656037ull;
+		for (uint32 w=0; w<words; ++w)
+		{
+			h = (h ^ key[w]) * 1099511628211ull;
+		}
+		return uint32(h ^ (h >> 32));
+	}
+
+	//キーが一致した頂点を元の値でも比べる(量子化の境界をまたいで離れた値を混ぜない)
+	inline bool
+	IsNear(const uint8* a, const uint8* b, uint32 words, float32 epsilon)
+	{
+		if (epsilon <= 0.0f)
+		{
+			return memcmp(a, b, words * sizeof(uint32)) == 0;
+		}
+		auto va = reinterpret_cast<const float32*>(a);
+		auto vb = reinterpret_cast<const float32*>(b);
+		for (uint32 w=0; w<words; ++w)
+		{
+			if (!(fabsf(va[w] - vb[w]) <= epsilon) && memcmp(&va[w], &vb[w], sizeof(float32)) != 0)
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+}
+
+
+uint32 VertexWelder::
+Weld(void* vertices, uint32 strideBytes, uint32 vertexCount, uint32* indices, size_t indexCount, float32 epsilon)
+{
+	if (vertexCount == 0 || (strideBytes % sizeof(uint32)) != 0)
+	{
+		return vertexCount;
+	}
+	auto bytes = static_cast<uint8*>(vertices);
+	const uint32 words = strideBytes / sizeof(uint32);
+	const float64 invEpsilon = (epsilon > 0.0f) ? 1.0 / float64(epsilon) : 0.0;
+
+	//キーは頂点ごとに1度だけ作る
+	std::vector<uint64> keys(size_t(vertexCount) * words);
+	for (uint32 idx=0; idx<vertexCount; ++idx)
+	{
+		MakeKey(bytes + size_t(idx) * strideBytes, words, invEpsilon, &keys[size_t(idx) * words]);
+	}
+
+	//オープンアドレス法のハッシュテーブル(要素は元の頂点番号)
+	uint32 tableSize = 1;
+	while (tableSize < vertexCount * 2)
+	{
+		tableSize <<= 1;
+	}
+	std::vector<uint32> table(tableSize, ~0u);
+	std::vector<uint32> remap(vertexCount);
+	uint32 uniqueCount = 0;
+	for (uint32 idx=0; idx<vertexCount; ++idx)
+	{
+		const uint64* key = &keys[size_t(idx) * words];
+		uint32 slot = HashKey(key, words) & (tableSize - 1);
+		for (;;)
+		{
+			uint32 entry = table[slot];
+			if (entry == ~0u)
+			{
+				//初出の頂点は前へ詰める(常にidx以下の位置なのでその場で移動できる)
+				table[slot] = idx;
+				remap[idx] = uniqueCount;
+				if (uniqueCount != idx)
+				{
+					memcpy(bytes + size_t(uniqueCount) * strideBytes, bytes + size_t(idx) * strideBytes, strideBytes);
+				}
+				++uniqueCount;
+				break;
+			}
+			//entryはすでにremap[entry]の位置へ詰めてある
+			if (memcmp(&keys[size_t(entry) * words], key, words * sizeof(uint64)) == 0
+				&& IsNear(bytes + size_t(remap[entry]) * strideBytes, bytes + size_t(idx) * strideBytes, words, epsilon))
+			{
+				remap[idx] = remap[entry];
+				break;
+			}
+			slot = (slot + 1) & (tableSize - 1);
+		}
+	}
+
+	for (size_t idx=0; idx<indexCount; ++idx)
+	{
+		indices[idx] = remap[indices[idx]];
+	}
+	return uniqueCount;
+}
@@ -0,0 +1,15 @@
+﻿#pragma once
+
+#include <vector>
+
+
+//ハッシュで重複頂点をまとめ、インデックスを書き換える
+class VertexWelder
+{
+public:
+	//頂点はfloat32の並びとして比較する。epsilonが0ならビット単位で一致するものだけをまとめ、
+	//正ならepsilon間隔で量子化した値が一致し、元の値の差もepsilon以内のものをまとめる(量子化できない大きさの値はビット単位で比べる)
+	//verticesは先頭から詰め直され、新しい頂点数を返す
+	static uint32
+	Weld(void* vertices, uint32 strideBytes, uint32 vertexCount, uint32* indices, size_t indexCount, float32 epsilon);
+};
@@ -0,0 +1,156 @@
+﻿#include "pch.h"
+#include "BoundsTable.h"
+#include <emmintrin.h>
+
+using namespace glm;
+
+
+namespace
+{
+	inline const float32*
+	PositionAt(const float32* positions, uint32 strideBytes, uint32 index)
+	{
+		return reinterpret_cast<const float32*>(reinterpret_cast<const uint8*>(positions) + size_t(index) * strideBytes);
+	}
+
+	//xyzの3要素を読む(4要素目は不定)
+	inline __m128
+	LoadPosition(const float32* p, bool wide)
+	{
+		if (wide)
+		{
+			return _mm_loadu_ps(p);
+		}
+		return _mm_setr_ps(p[0], p[1], p[2], 0.0f);
+	}
+}
+
+
+BoundsTable::
+BoundsTable()
+: centerX(), centerY(), centerZ(), radius()
+, minX(), minY(), minZ()
+, maxX(), maxY(), maxZ()
+, m_size(0)
+{
+}
+
+uint32 BoundsTable::
+Add(const vec3& aabbMin, const vec3& aabbMax, const vec3& center, float32 sphereRadius)
+{
+	uint32 index = m_size++;
+	if (index == PaddedSize())
+	{
+		//パディング要素は半径が負なのでどの平面に対しても外側になる
+		uint32 padded = PaddedSize() + Alignment;
+		for (auto* v : { &centerX, &centerY, &centerZ, &minX, &minY, &minZ, &maxX, &maxY, &maxZ })
+		{
+			v->resize(padded, 0.0f);
+		}
+		radius.resize(padded, -FLT_MAX);
+	}
+	Set(index, aabbMin, aabbMax, center, sphereRadius);
+	return index;
+}
+
+void BoundsTable::
+Set(uint32 idx, const vec3& aabbMin, const vec3& aabbMax, const vec3& center, float32 sphereRadius)
+{
+	centerX[idx] = center.x;
+	centerY[idx] = center.y;
+	centerZ[idx] = center.z;
+	radius[idx] = sphereRadius;
+	minX[idx] = aabbMin.x;
+	minY[idx] = aabbMin.y;
+	minZ[idx] = aabbMin.z;
+	maxX[idx] = aabbMax.x;
+	maxY[idx] = aabbMax.y;
+	maxZ[idx] = aabbMax.z;
+}
+
+void BoundsTable::
+Clear(void)
+{
+	for (auto* v : { &centerX, &centerY, &centerZ, &radius, &minX, &minY, &minZ, &maxX, &maxY, &maxZ })
+	{
+		v->clear();
+	}
+	m_size = 0;
+}
+
+void BoundsTable::
+ComputeAabb(const float32* positions, uint32 strideBytes, const uint32* indices, size_t indexCount, vec3& aabbMin, vec3& aabbMax)
+{
+	if (indexCount == 0)
+	{
+		aabbMin = aabbMax = vec3(0.0f);
+		return;
+	}
+	//ストライドが16バイト以上なら4要素まとめて読んでもはみ出さない
+	const bool wide = strideBytes >= 16;
+
+	//依存チェーンを切るため4系統で並行にmin/maxを取る
+	__m128 first = LoadPosition(PositionAt(positions, strideBytes, indices[0]), wide);
+	__m128 mn[4] = { first, first, first, first };
+	__m128 mx[4] = { first, first, first, first };
+	size_t idx = 0;
+	for (; idx+4<=indexCount; idx+=4)
+	{
+		for (uint32 k=0; k<4; ++k)
+		{
+			__m128 p = LoadPosition(PositionAt(positions, strideBytes, indices[idx + k]), wide);
+			mn[k] = _mm_min_ps(mn[k], p);
+			mx[k] = _mm_max_ps(mx[k], p);
+		}
+	}
+	for (; idx<indexCount; ++idx)
+	{
+		__m128 p = LoadPosition(PositionAt(positions, strideBytes, indices[idx]), wide);
+		mn[0] = _mm_min_ps(mn[0], p);
+		mx[0] = _mm_max_ps(mx[0], p);
+	}
+	__m128 resultMin = _mm_min_ps(_mm_min_ps(mn[0], mn[1]), _mm_min_ps(mn[2], mn[3]));
+	__m128 resultMax = _mm_max_ps(_mm_max_ps(mx[0], mx[1]), _mm_max_ps(mx[2], mx[3]));
+
+	alignas(16) float32 outMin[4], outMax[4];
+	_mm_store_ps(outMin, resultMin);
+	_mm_store_ps(outMax, resultMax);
+	aabbMin = vec3(outMin[0], outMin[1], outMin[2]);
+	aabbMax = vec3(outMax[0], outMax[1], outMax[2]);
+}
+
+float32 BoundsTable::
+ComputeRadius(const float32* positions, uint32 strideBytes, const uint32* indices, size_t indexCount, const vec3& center)
+{
+	const bool wide = strideBytes >= 16;
+	const __m128 cx = _mm_set1_ps(center.x);
+	const __m128 cy = _mm_set1_ps(center.y);
+	const __m128 cz = _mm_set1_ps(center.z);
+
+	//4頂点ずつ転置してx/y/z列に並べ、距離の2乗を4つ同時に求める
+	__m128 maxDistSq = _mm_setzero_ps();
+	size_t idx = 0;
+	for (; idx+4<=indexCount; idx+=4)
+	{
+		__m128 p0 = LoadPosition(PositionAt(positions, strideBytes, indices[idx + 0]), wide);
+		__m128 p1 = LoadPosition(PositionAt(positions, strideBytes, indices[idx + 1]), wide);
+		__m128 p2 = LoadPosition(PositionAt(positions, strideBytes, indices[idx + 2]), wide);
+		__m128 p3 = LoadPosition(PositionAt(positions, strideBytes, indices[idx + 3]), wide);
+		_MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+		__m128 dx = _mm_sub_ps(p0, cx);
+		__m128 dy = _mm_sub_ps(p1, cy);
+		__m128 dz = _mm_sub_ps(p2, cz);
+		__m128 distSq = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+		maxDistSq = _mm_max_ps(maxDistSq, distSq);
+	}
+	alignas(16) float32 lanes[4];
+	_mm_store_ps(lanes, maxDistSq);
+	float32 result = (std::max)((std::max)(lanes[0], lanes[1]), (std::max)(lanes[2], lanes[3]));
+	for (; idx<indexCount; ++idx)
+	{
+		auto p = PositionAt(positions, strideBytes, indices[idx]);
+		vec3 d = vec3(p[0], p[1], p[2]) - center;
+		result = (std::max)(result, dot(d, d));
+	}
+	return sqrtf(result);
+}
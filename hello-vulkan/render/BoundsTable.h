@@ -0,0 +1,52 @@
+﻿#pragma once
+
+#include <vector>
+
+
+//メッシュごとのAABBとバウンディングスフィアをSoAで保持する
+//カリングやソートで要素をまとめて走査できるよう、各配列はSIMD幅の倍数に切り上げて確保する
+class BoundsTable
+{
+public:
+	static const uint32 Alignment = 8;
+
+public:
+	BoundsTable();
+
+	uint32
+	Add(const glm::vec3& aabbMin, const glm::vec3& aabbMax, const glm::vec3& center, float32 radius);
+	void
+	Set(uint32 idx, const glm::vec3& aabbMin, const glm::vec3& aabbMax, const glm::vec3& center, float32 radius);
+	void
+	Clear(void);
+	uint32
+	Size(void) const { return m_size; }
+	//SIMD幅に切り上げた要素数(パディング要素は常にカリングされる値を持つ)
+	uint32
+	PaddedSize(void) const { return uint32(centerX.size()); }
+
+	glm::vec3
+	GetCenter(uint32 idx) const { return glm::vec3(centerX[idx], centerY[idx], centerZ[idx]); }
+	float32
+	GetRadius(uint32 idx) const { return radius[idx]; }
+	glm::vec3
+	GetMin(uint32 idx) const { return glm::vec3(minX[idx], minY[idx], minZ[idx]); }
+	glm::vec3
+	GetMax(uint32 idx) const { return glm::vec3(maxX[idx], maxY[idx], maxZ[idx]); }
+
+public:
+	//位置列(indicesで参照される頂点)のAABBをSIMDのmin/maxで求める
+	static void
+	ComputeAabb(const float32* positions, uint32 strideBytes, const uint32* indices, size_t indexCount, glm::vec3& aabbMin, glm::vec3& aabbMax);
+	//centerから最も遠い頂点までの距離をSIMDで求める
+	static float32
+	ComputeRadius(const float32* positions, uint32 strideBytes, const uint32* indices, size_t indexCount, const glm::vec3& center);
+
+public:
+	std::vector<float32> centerX, centerY, centerZ, radius;
+	std::vector<float32> minX, minY, minZ;
+	std::vector<float32> maxX, maxY, maxZ;
+
+private:
+	uint32 m_size;
+};
@@ -0,0 +1,56 @@
+﻿#include "pch.h"
+#include "ClusterCuller.h"
+
+using namespace glm;
+
+
+uint32 ClusterCuller::
+Cull(const Frustum& frustum, const vec3& eye, const mat4& world, bool backfaceCull, const HiZBuffer* occlusion, const std::vector<Meshlet>& meshlets, std::vector<DrawRange>& ranges)
+{
+	//半径は最も大きく伸びる軸の倍率で広げる
+	mat3 basis(world);
+	float32 scaleSq[3] = { dot(basis[0], basis[0]), dot(basis[1], basis[1]), dot(basis[2], basis[2]) };
+	float32 maxScaleSq = (std::max)((std::max)(scaleSq[0], scaleSq[1]), scaleSq[2]);
+	float32 minScaleSq = (std::min)((std::min)(scaleSq[0], scaleSq[1]), scaleSq[2]);
+	float32 scale = sqrtf(maxScaleSq);
+	//非一様スケールでは法線コーンが保たれないので背面カリングしない
+	backfaceCull = backfaceCull && (maxScaleSq - minScaleSq) <= maxScaleSq * 1.0e-3f;
+
+	uint32 visibleCount = 0;
+	bool extend = false;
+	for (const auto& m : meshlets)
+	{
+		vec3 center = vec3(world * vec4(m.center, 1.0f));
+		float32 radius = m.radius * scale;
+		bool visible = frustum.TestSphere(center, radius);
+		if (visible && backfaceCull && m.coneCutoff < 1.0f)
+		{
+			//コーン内のすべての面が裏向きなら描画しない
+			vec3 dir = vec3(world * vec4(m.coneApex, 1.0f)) - eye;
+			vec3 axis = normalize(basis * m.coneAxis);
+			float32 len = length(dir);
+			visible = !(len > 0.0f && dot(dir / len, axis) >= m.coneCutoff);
+		}
+		if (visible && occlusion != nullptr)
+		{
+			visible = !occlusion->IsOccluded(center, radius);
+		}
+		if (!visible)
+		{
+			extend = false;
+			continue;
+		}
+
+		++visibleCount;
+		if (extend)
+		{
+			ranges.back().indexCount += m.indexCount;
+		}
+		else
+		{
+			ranges.push_back(DrawRange{ m.firstIndex, m.indexCount });
+			extend = true;
+		}
+	}
+	return visibleCount;
+}
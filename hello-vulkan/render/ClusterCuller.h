@@ -0,0 +1,26 @@
+﻿#pragma once
+
+#include <vector>
+#include "model/MeshletBuilder.h"
+#include "render/Frustum.h"
+#include "render/HiZBuffer.h"
+
+
+//描画するインデックス範囲
+struct DrawRange
+{
+	uint32 firstIndex;
+	uint32 indexCount;
+};
+
+
+//メッシュレット単位のCPUカリング
+class ClusterCuller
+{
+public:
+	//可視メッシュレットを連続する範囲にまとめてrangesへ追加し、可視数を返す
+	//メッシュレットはworldでワールド空間へ移してから判定する
+	//occlusionを渡すと前フレームの深度で隠れているものも除く
+	static uint32
+	Cull(const Frustum& frustum, const glm::vec3& eye, const glm::mat4& world, bool backfaceCull, const HiZBuffer* occlusion, const std::vector<Meshlet>& meshlets, std::vector<DrawRange>& ranges);
+};
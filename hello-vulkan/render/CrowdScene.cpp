@@ -0,0 +1,95 @@
+﻿#include "pch.h"
+#include "CrowdScene.h"
+#include <random>
+#include "render/FrustumCuller.h"
+
+using namespace glm;
+
+
+CrowdScene::
+CrowdScene()
+: m_worlds()
+, m_tints()
+, m_lods()
+, m_bounds()
+, m_modelCenter(0.0f)
+, m_modelRadius(0.0f)
+, m_visible()
+, m_instances()
+, m_instanceIds()
+, m_lodStarts()
+{
+}
+
+void CrowdScene::
+Build(uint32 count, const vec3& modelCenter, float32 modelRadius)
+{
+	const float32 spacing = 0.75f;
+
+	m_modelCenter = modelCenter;
+	m_modelRadius = modelRadius;
+	m_worlds.resize(count);
+	m_tints.resize(count);
+	m_lods.assign(count, 0);
+	m_bounds.Clear();
+	m_instances.reserve(count);
+	m_instanceIds.reserve(count);
+
+	//原点から+Z方向へ正方形に並べ、向きと色を少しずつばらつかせる
+	std::mt19937 rng(count);
+	std::uniform_real_distribution<float32> angle(-0.5f, 0.5f);
+	std::uniform_real_distribution<float32> color(0.6f, 1.0f);
+	uint32 columns = uint32(ceil(sqrt(float32(count))));
+	for (uint32 idx=0; idx<count; ++idx)
+	{
+		vec3 pos(
+			(float32(idx % columns) - float32(columns - 1) * 0.5f) * spacing,
+			0.0f,
+			float32(idx / columns) * spacing);
+		m_worlds[idx] = rotate(translate(mat4(1.0f), pos), angle(rng), vec3(0.0f, 1.0f, 0.0f));
+		m_tints[idx] = vec4(color(rng), color(rng), color(rng), 1.0f);
+
+		//回転しても収まるよう球を包む箱を境界にする
+		vec3 center = vec3(m_worlds[idx] * vec4(modelCenter, 1.0f));
+		m_bounds.Add(center - vec3(modelRadius), center + vec3(modelRadius), center, modelRadius);
+	}
+}
+
+uint32 CrowdScene::
+Update(const Frustum& frustum, const vec3& eye, float32 fovY, uint32 lodCount)
+{
+	FrustumCuller::Cull(frustum, m_bounds, m_visible);
+
+	//LODを選び、LODごとの数を数える
+	uint32 counts[LodSelector::MaxLods] = {};
+	for (auto idx : m_visible)
+	{
+		float32 size = LodSelector::ProjectedSize(m_bounds.GetCenter(idx), m_modelRadius, eye, fovY);
+		m_lods[idx] = LodSelector::Select(size, m_lods[idx], lodCount);
+		++counts[m_lods[idx]];
+	}
+	m_lodStarts[0] = 0;
+	for (uint32 lod=0; lod<LodSelector::MaxLods; ++lod)
+	{
+		m_lodStarts[lod + 1] = m_lodStarts[lod] + counts[lod];
+	}
+
+	//LODごとに連続するよう並べる(同じLODはインスタンス番号順)
+	uint32 cursor[LodSelector::MaxLods];
+	for (uint32 lod=0; lod<LodSelector::MaxLods; ++lod)
+	{
+		cursor[lod] = m_lodStarts[lod];
+	}
+	m_instances.resize(m_visible.size());
+	m_instanceIds.resize(m_visible.size());
+	for (auto idx : m_visible)
+	{
+		uint32 lod = m_lods[idx];
+		m_instanceIds[cursor[lod]] = idx;
+		auto& inst = m_instances[cursor[lod]++];
+		inst.world = m_worlds[idx];
+		inst.tint = m_tints[idx];
+		inst.lod = lod;
+	}
+	return uint32(m_visible.size());
+}
@@ -0,0 +1,55 @@
+﻿#pragma once
+
+#include <vector>
+#include "render/BoundsTable.h"
+#include "render/Frustum.h"
+#include "render/LodSelector.h"
+
+
+//同じモデルを多数並べた群衆の配置と、フレームごとの可視判定・LODの振り分け
+class CrowdScene
+{
+public:
+	//インスタンスごとの頂点入力(ModelAppの頂点バインディング1と同じ並び)
+	struct InstanceData
+	{
+		glm::mat4 world;
+		glm::vec4 tint;
+		uint32 lod;
+		uint32 padding[3];
+	};
+
+public:
+	CrowdScene();
+
+	//count体を格子状に並べる modelCenter/modelRadiusはモデル全体のローカル空間の境界
+	void
+	Build(uint32 count, const glm::vec3& modelCenter, float32 modelRadius);
+	uint32
+	Size(void) const { return uint32(m_worlds.size()); }
+
+	//視錐台外を除き、見えるものをLODの昇順に並べて書き出す 戻り値は可視数
+	uint32
+	Update(const Frustum& frustum, const glm::vec3& eye, float32 fovY, uint32 lodCount);
+
+	const std::vector<InstanceData>&
+	GetInstances(void) const { return m_instances; }
+	//LODごとの開始位置(lod == MaxLodsで可視数)
+	uint32
+	GetLodStart(uint32 lod) const { return m_lodStarts[lod]; }
+	//GetInstancesのslot番目のインスタンス番号(フレームをまたいで同じ個体を指す)
+	uint32
+	GetInstanceId(uint32 slot) const { return m_instanceIds[slot]; }
+
+private:
+	std::vector<glm::mat4> m_worlds;
+	std::vector<glm::vec4> m_tints;
+	std::vector<uint32> m_lods;			//ヒステリシスのため前フレームのLODを残す
+	BoundsTable m_bounds;				//ワールド空間の境界
+	glm::vec3 m_modelCenter;
+	float32 m_modelRadius;
+	std::vector<uint32> m_visible;
+	std::vector<InstanceData> m_instances;
+	std::vector<uint32> m_instanceIds;	//m_instancesと同じ並び
+	uint32 m_lodStarts[LodSelector::MaxLods + 1];
+};
@@ -0,0 +1,82 @@
+﻿#include "pch.h"
+#include "DrawQueue.h"
+
+
+uint64 DrawKey::
+Make(uint32 pass, uint32 pipeline, uint32 material, float32 depth)
+{
+	//正の浮動小数点数はビット列のまま整数として比較しても順序が保たれる
+	uint32 depthBits = 0;
+	if (depth > 0.0f)
+	{
+		memcpy(&depthBits, &depth, sizeof(depthBits));
+	}
+	uint64 key = uint64(pass & ((1u << PassBits) - 1));
+	key = (key << PipelineBits) | (pipeline & ((1u << PipelineBits) - 1));
+	key = (key << MaterialBits) | (material & ((1u << MaterialBits) - 1));
+	key = (key << DepthBits) | depthBits;
+	return key;
+}
+
+
+DrawQueue::
+DrawQueue()
+: m_entries()
+, m_scratch()
+{
+}
+
+void DrawQueue::
+Sort(void)
+{
+	RadixSort(m_entries, m_scratch);
+}
+
+void DrawQueue::
+RadixSort(std::vector<Entry>& entries, std::vector<Entry>& scratch)
+{
+	const size_t count = entries.size();
+	if (count <= 1)
+	{
+		return;
+	}
+	scratch.resize(count);
+
+	//全桁のヒストグラムを1回の走査で作る
+	uint32 histograms[8][256] = {};
+	for (const auto& e : entries)
+	{
+		for (uint32 digit=0; digit<8; ++digit)
+		{
+			++histograms[digit][(e.key >> (digit * 8)) & 0xff];
+		}
+	}
+
+	Entry* src = entries.data();
+	Entry* dst = scratch.data();
+	for (uint32 digit=0; digit<8; ++digit)
+	{
+		auto& histogram = histograms[digit];
+		//全要素が同じ値の桁は並びが変わらない
+		if (histogram[(src[0].key >> (digit * 8)) & 0xff] == count)
+		{
+			continue;
+		}
+		uint32 offset = 0;
+		for (uint32 bucket=0; bucket<256; ++bucket)
+		{
+			uint32 n = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += n;
+		}
+		for (size_t idx=0; idx<count; ++idx)
+		{
+			dst[histogram[(src[idx].key >> (digit * 8)) & 0xff]++] = src[idx];
+		}
+		std::swap(src, dst);
+	}
+	if (src != entries.data())
+	{
+		entries.swap(scratch);
+	}
+}
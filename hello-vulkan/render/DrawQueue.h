@@ -0,0 +1,62 @@
+﻿#pragma once
+
+#include <vector>
+
+
+//描画順を決める64bitのソートキー
+//上位ビットから pass:4 | pipeline:8 | material:20 | depth:32
+class DrawKey
+{
+public:
+	static const uint32 PassBits = 4;
+	static const uint32 PipelineBits = 8;
+	static const uint32 MaterialBits = 20;
+	static const uint32 DepthBits = 32;
+
+public:
+	//depthはビュー空間の距離(負の値は0として扱う)
+	static uint64
+	Make(uint32 pass, uint32 pipeline, uint32 material, float32 depth);
+
+	static uint32
+	GetPass(uint64 key) { return uint32(key >> (PipelineBits + MaterialBits + DepthBits)); }
+	static uint32
+	GetPipeline(uint64 key) { return uint32(key >> (MaterialBits + DepthBits)) & ((1u << PipelineBits) - 1); }
+	static uint32
+	GetMaterial(uint64 key) { return uint32(key >> DepthBits) & ((1u << MaterialBits) - 1); }
+};
+
+
+//ソートキーと描画単位の組を毎フレーム集めて並べ替える
+class DrawQueue
+{
+public:
+	struct Entry
+	{
+		uint64 key;
+		uint32 item;	//呼び出し側の描画単位の番号
+	};
+
+public:
+	DrawQueue();
+
+	void
+	Clear(void) { m_entries.clear(); }
+	void
+	Push(uint64 key, uint32 item) { m_entries.push_back(Entry{ key, item }); }
+	//キーの昇順に並べ替える(同じキーは追加順を保つ)
+	void
+	Sort(void);
+
+	const std::vector<Entry>&
+	GetEntries(void) const { return m_entries; }
+
+public:
+	//8bitずつのLSD基数ソート 全要素で同じ値の桁は飛ばす
+	static void
+	RadixSort(std::vector<Entry>& entries, std::vector<Entry>& scratch);
+
+private:
+	std::vector<Entry> m_entries;
+	std::vector<Entry> m_scratch;
+};
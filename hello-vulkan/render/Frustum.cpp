@@ -0,0 +1,42 @@
+﻿#include "pch.h"
+#include "Frustum.h"
+
+using namespace glm;
+
+
+Frustum Frustum::
+FromMatrix(const mat4& viewProj)
+{
+	//glmは列優先なので行ベクトルを組み立てる
+	vec4 row[4];
+	for (int32 r=0; r<4; ++r)
+	{
+		row[r] = vec4(viewProj[0][r], viewProj[1][r], viewProj[2][r], viewProj[3][r]);
+	}
+
+	Frustum frustum;
+	frustum.planes[Left] = row[3] + row[0];
+	frustum.planes[Right] = row[3] - row[0];
+	frustum.planes[Bottom] = row[3] + row[1];
+	frustum.planes[Top] = row[3] - row[1];
+	frustum.planes[Near] = row[3] + row[2];
+	frustum.planes[Far] = row[3] - row[2];
+	for (auto& p : frustum.planes)
+	{
+		p /= length(vec3(p));
+	}
+	return frustum;
+}
+
+bool Frustum::
+TestSphere(const vec3& center, float32 radius) const
+{
+	for (const auto& p : planes)
+	{
+		if (dot(vec3(p), center) + p.w < -radius)
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,19 @@
+﻿#pragma once
+
+
+//ビュープロジェクション行列から抽出した視錐台(平面は内向き、正規化済み)
+struct Frustum
+{
+	enum
+	{
+		Left, Right, Bottom, Top, Near, Far,
+		PlaneCount
+	};
+	glm::vec4 planes[PlaneCount];
+
+	static Frustum
+	FromMatrix(const glm::mat4& viewProj);
+
+	bool
+	TestSphere(const glm::vec3& center, float32 radius) const;
+};
@@ -0,0 +1,203 @@
+﻿#include "pch.h"
+#include "FrustumCuller.h"
+#include <intrin.h>
+#include <immintrin.h>
+
+using namespace glm;
+
+
+uint32 FrustumCuller::
+Cull(const Frustum& frustum, const BoundsTable& bounds, std::vector<uint32>& visible, Path path)
+{
+	//SIMD版はパディング込みで書き込むので余裕を持たせる
+	visible.resize(bounds.PaddedSize());
+	if (bounds.Size() == 0)
+	{
+		visible.clear();
+		return 0;
+	}
+
+	if (path == PathAuto)
+	{
+		path = IsAvxSupported() ? PathAvx : PathSse;
+	}
+	uint32 count = 0;
+	switch (path)
+	{
+	case PathAvx:
+		count = _CullAvx(frustum, bounds, visible.data());
+		break;
+	case PathSse:
+		count = _CullSse(frustum, bounds, visible.data());
+		break;
+	default:
+		count = _CullScalar(frustum, bounds, visible.data());
+		break;
+	}
+	visible.resize(count);
+	return count;
+}
+
+bool FrustumCuller::
+IsAvxSupported(void)
+{
+	static const bool supported = []()
+	{
+		int32 info[4];
+		__cpuid(info, 1);
+		//AVX命令とOSによるYMMレジスタ保存の両方が必要
+		bool osxsave = (info[2] & (1 << 27)) != 0;
+		bool avx = (info[2] & (1 << 28)) != 0;
+		if (!osxsave || !avx)
+		{
+			return false;
+		}
+		return (_xgetbv(0) & 0x6) == 0x6;
+	}();
+	return supported;
+}
+
+uint32 FrustumCuller::
+_CullScalar(const Frustum& frustum, const BoundsTable& bounds, uint32* visible)
+{
+	uint32 count = 0;
+	for (uint32 idx=0; idx<bounds.Size(); ++idx)
+	{
+		bool inside = true;
+		for (const auto& p : frustum.planes)
+		{
+			//球
+			float32 d = p.x * bounds.centerX[idx] + p.y * bounds.centerY[idx] + p.z * bounds.centerZ[idx] + p.w;
+			if (d < -bounds.radius[idx])
+			{
+				inside = false;
+				break;
+			}
+			//AABBの平面法線側に最も出ている頂点
+			float32 vx = (p.x >= 0.0f) ? bounds.maxX[idx] : bounds.minX[idx];
+			float32 vy = (p.y >= 0.0f) ? bounds.maxY[idx] : bounds.minY[idx];
+			float32 vz = (p.z >= 0.0f) ? bounds.maxZ[idx] : bounds.minZ[idx];
+			if (p.x * vx + p.y * vy + p.z * vz + p.w < 0.0f)
+			{
+				inside = false;
+				break;
+			}
+		}
+		if (inside)
+		{
+			visible[count++] = idx;
+		}
+	}
+	return count;
+}
+
+uint32 FrustumCuller::
+_CullSse(const Frustum& frustum, const BoundsTable& bounds, uint32* visible)
+{
+	//平面ごとに法線の符号で参照するAABB配列を決めておく
+	const float32* px[Frustum::PlaneCount];
+	const float32* py[Frustum::PlaneCount];
+	const float32* pz[Frustum::PlaneCount];
+	__m128 nx[Frustum::PlaneCount], ny[Frustum::PlaneCount], nz[Frustum::PlaneCount], nw[Frustum::PlaneCount];
+	for (uint32 i=0; i<Frustum::PlaneCount; ++i)
+	{
+		const auto& p = frustum.planes[i];
+		px[i] = (p.x >= 0.0f) ? bounds.maxX.data() : bounds.minX.data();
+		py[i] = (p.y >= 0.0f) ? bounds.maxY.data() : bounds.minY.data();
+		pz[i] = (p.z >= 0.0f) ? bounds.maxZ.data() : bounds.minZ.data();
+		nx[i] = _mm_set1_ps(p.x);
+		ny[i] = _mm_set1_ps(p.y);
+		nz[i] = _mm_set1_ps(p.z);
+		nw[i] = _mm_set1_ps(p.w);
+	}
+
+	const __m128 zero = _mm_setzero_ps();
+	uint32 count = 0;
+	const uint32 size = bounds.Size();
+	for (uint32 base=0; base<size; base+=4)
+	{
+		__m128 cx = _mm_loadu_ps(&bounds.centerX[base]);
+		__m128 cy = _mm_loadu_ps(&bounds.centerY[base]);
+		__m128 cz = _mm_loadu_ps(&bounds.centerZ[base]);
+		__m128 negR = _mm_sub_ps(zero, _mm_loadu_ps(&bounds.radius[base]));
+
+		//外側判定をビットORで積み上げる
+		__m128 outside = zero;
+		for (uint32 i=0; i<Frustum::PlaneCount; ++i)
+		{
+			__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[i], cx), _mm_mul_ps(ny[i], cy)), _mm_add_ps(_mm_mul_ps(nz[i], cz), nw[i]));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(d, negR));
+
+			__m128 vx = _mm_loadu_ps(px[i] + base);
+			__m128 vy = _mm_loadu_ps(py[i] + base);
+			__m128 vz = _mm_loadu_ps(pz[i] + base);
+			__m128 e = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[i], vx), _mm_mul_ps(ny[i], vy)), _mm_add_ps(_mm_mul_ps(nz[i], vz), nw[i]));
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(e, zero));
+		}
+
+		//可視レーンの番号を詰めて書き出す(パディング要素は常に外側)
+		uint32 mask = uint32(~_mm_movemask_ps(outside)) & 0xfu;
+		while (mask != 0)
+		{
+			unsigned long bit;
+			_BitScanForward(&bit, mask);
+			visible[count++] = base + bit;
+			mask &= mask - 1;
+		}
+	}
+	return count;
+}
+
+uint32 FrustumCuller::
+_CullAvx(const Frustum& frustum, const BoundsTable& bounds, uint32* visible)
+{
+	const float32* px[Frustum::PlaneCount];
+	const float32* py[Frustum::PlaneCount];
+	const float32* pz[Frustum::PlaneCount];
+	__m256 nx[Frustum::PlaneCount], ny[Frustum::PlaneCount], nz[Frustum::PlaneCount], nw[Frustum::PlaneCount];
+	for (uint32 i=0; i<Frustum::PlaneCount; ++i)
+	{
+		const auto& p = frustum.planes[i];
+		px[i] = (p.x >= 0.0f) ? bounds.maxX.data() : bounds.minX.data();
+		py[i] = (p.y >= 0.0f) ? bounds.maxY.data() : bounds.minY.data();
+		pz[i] = (p.z >= 0.0f) ? bounds.maxZ.data() : bounds.minZ.data();
+		nx[i] = _mm256_set1_ps(p.x);
+		ny[i] = _mm256_set1_ps(p.y);
+		nz[i] = _mm256_set1_ps(p.z);
+		nw[i] = _mm256_set1_ps(p.w);
+	}
+
+	const __m256 zero = _mm256_setzero_ps();
+	uint32 count = 0;
+	const uint32 size = bounds.Size();
+	for (uint32 base=0; base<size; base+=8)
+	{
+		__m256 cx = _mm256_loadu_ps(&bounds.centerX[base]);
+		__m256 cy = _mm256_loadu_ps(&bounds.centerY[base]);
+		__m256 cz = _mm256_loadu_ps(&bounds.centerZ[base]);
+		__m256 negR = _mm256_sub_ps(zero, _mm256_loadu_ps(&bounds.radius[base]));
+
+		__m256 outside = zero;
+		for (uint32 i=0; i<Frustum::PlaneCount; ++i)
+		{
+			__m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[i], cx), _mm256_mul_ps(ny[i], cy)), _mm256_add_ps(_mm256_mul_ps(nz[i], cz), nw[i]));
+			outside = _mm256_or_ps(outside, _mm256_cmp_ps(d, negR, _CMP_LT_OQ));
+
+			__m256 vx = _mm256_loadu_ps(px[i] + base);
+			__m256 vy = _mm256_loadu_ps(py[i] + base);
+			__m256 vz = _mm256_loadu_ps(pz[i] + base);
+			__m256 e = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[i], vx), _mm256_mul_ps(ny[i], vy)), _mm256_add_ps(_mm256_mul_ps(nz[i], vz), nw[i]));
+			outside = _mm256_or_ps(outside, _mm256_cmp_ps(e, zero, _CMP_LT_OQ));
+		}
+
+		uint32 mask = uint32(~_mm256_movemask_ps(outside)) & 0xffu;
+		while (mask != 0)
+		{
+			unsigned long bit;
+			_BitScanForward(&bit, mask);
+			visible[count++] = base + bit;
+			mask &= mask - 1;
+		}
+	}
+	return count;
+}
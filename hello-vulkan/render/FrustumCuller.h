@@ -0,0 +1,36 @@
+﻿#pragma once
+
+#include <vector>
+#include "render/BoundsTable.h"
+#include "render/Frustum.h"
+
+
+//BoundsTableの要素をまとめて視錐台と判定する
+//球で粗く判定し、残ったものをAABB(正側頂点)で判定する
+class FrustumCuller
+{
+public:
+	enum Path
+	{
+		PathAuto,
+		PathScalar,
+		PathSse,
+		PathAvx,
+	};
+
+public:
+	//可視要素の番号を昇順でvisibleへ書き出し、可視数を返す
+	static uint32
+	Cull(const Frustum& frustum, const BoundsTable& bounds, std::vector<uint32>& visible, Path path = PathAuto);
+
+	static bool
+	IsAvxSupported(void);
+
+private:
+	static uint32
+	_CullScalar(const Frustum& frustum, const BoundsTable& bounds, uint32* visible);
+	static uint32
+	_CullSse(const Frustum& frustum, const BoundsTable& bounds, uint32* visible);
+	static uint32
+	_CullAvx(const Frustum& frustum, const BoundsTable& bounds, uint32* visible);
+};
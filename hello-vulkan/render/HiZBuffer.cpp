@@ -0,0 +1,86 @@
+﻿#include "pch.h"
+#include "HiZBuffer.h"
+
+using namespace glm;
+
+
+HiZBuffer::
+HiZBuffer()
+: m_width(0)
+, m_height(0)
+, m_texelPixels(1)
+, m_screenWidth(0)
+, m_screenHeight(0)
+, m_depth()
+, m_viewProj(1.0f)
+, m_valid(false)
+{
+}
+
+void HiZBuffer::
+Update(const float32* depth, uint32 width, uint32 height, uint32 texelPixels, uint32 screenWidth, uint32 screenHeight, const mat4& viewProj)
+{
+	m_width = width;
+	m_height = height;
+	m_texelPixels = (std::max)(texelPixels, 1u);
+	m_screenWidth = screenWidth;
+	m_screenHeight = screenHeight;
+	m_depth.assign(depth, depth + size_t(width) * height);
+	m_viewProj = viewProj;
+	m_valid = (width > 0 && height > 0);
+}
+
+bool HiZBuffer::
+IsOccluded(const vec3& aabbMin, const vec3& aabbMax) const
+{
+	if (!m_valid)
+	{
+		return false;
+	}
+
+	//8頂点を投影して画面上の矩形と最も手前の深度を求める
+	vec2 ndcMin(FLT_MAX), ndcMax(-FLT_MAX);
+	float32 nearestDepth = FLT_MAX;
+	for (uint32 corner=0; corner<8; ++corner)
+	{
+		vec3 p((corner & 1) ? aabbMax.x : aabbMin.x, (corner & 2) ? aabbMax.y : aabbMin.y, (corner & 4) ? aabbMax.z : aabbMin.z);
+		vec4 clip = m_viewProj * vec4(p, 1.0f);
+		if (clip.w <= 1.0e-5f)
+		{
+			//カメラの後ろにかかるものは判定しない
+			return false;
+		}
+		vec3 ndc = vec3(clip) / clip.w;
+		ndcMin = min(ndcMin, vec2(ndc));
+		ndcMax = max(ndcMax, vec2(ndc));
+		nearestDepth = (std::min)(nearestDepth, ndc.z);
+	}
+	if (ndcMax.x < -1.0f || ndcMax.y < -1.0f || ndcMin.x > 1.0f || ndcMin.y > 1.0f)
+	{
+		//画面外は視錐台カリングに任せる
+		return false;
+	}
+
+	//ビューポートは上下反転しているのでNDCのy=+1が先頭行になる
+	auto toTexel = [this](float32 v, uint32 screenSize, uint32 size)
+	{
+		uint32 pixel = uint32(clamp(v, 0.0f, 1.0f) * float32(screenSize));
+		return (std::min)(pixel / m_texelPixels, size - 1);
+	};
+	uint32 x0 = toTexel(ndcMin.x * 0.5f + 0.5f, m_screenWidth, m_width);
+	uint32 x1 = toTexel(ndcMax.x * 0.5f + 0.5f, m_screenWidth, m_width);
+	uint32 y0 = toTexel(0.5f - ndcMax.y * 0.5f, m_screenHeight, m_height);
+	uint32 y1 = toTexel(0.5f - ndcMin.y * 0.5f, m_screenHeight, m_height);
+	for (uint32 y=y0; y<=y1; ++y)
+	{
+		const float32* row = &m_depth[size_t(y) * m_width];
+		for (uint32 x=x0; x<=x1; ++x)
+		{
+			if (nearestDepth <= row[x])
+			{
+				return false;
+			}
+		}
+	}
+	return true;
+}
@@ -0,0 +1,40 @@
+﻿#pragma once
+
+#include <vector>
+
+
+//GPUで作った深度ピラミッドの粗い段をCPUへ読み戻したもの
+//各テクセルは覆う範囲の最も奥の深度を持つので、それより手前に何もない物体は隠れている
+class HiZBuffer
+{
+public:
+	HiZBuffer();
+
+	//depthはピラミッドの1段(上の行から)で、1テクセルが画面のtexelPixels四方を覆う(右端・下端の余りは最後のテクセルに含む)
+	//viewProjはその深度を描いたときの行列
+	void
+	Update(const float32* depth, uint32 width, uint32 height, uint32 texelPixels, uint32 screenWidth, uint32 screenHeight, const glm::mat4& viewProj);
+	void
+	Invalidate(void) { m_valid = false; }
+	bool
+	IsValid(void) const { return m_valid; }
+
+	//AABBが完全に遮蔽されていればtrue(判定できない場合は常にfalse)
+	bool
+	IsOccluded(const glm::vec3& aabbMin, const glm::vec3& aabbMax) const;
+	bool
+	IsOccluded(const glm::vec3& center, float32 radius) const
+	{
+		return IsOccluded(center - glm::vec3(radius), center + glm::vec3(radius));
+	}
+
+private:
+	uint32 m_width;
+	uint32 m_height;
+	uint32 m_texelPixels;
+	uint32 m_screenWidth;
+	uint32 m_screenHeight;
+	std::vector<float32> m_depth;
+	glm::mat4 m_viewProj;
+	bool m_valid;
+};
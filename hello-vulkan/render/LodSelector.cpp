@@ -0,0 +1,43 @@
+﻿#include "pch.h"
+#include "LodSelector.h"
+
+using namespace glm;
+
+
+//LOD i+1へ切り替わる投影サイズ
+const float32 LodSelector::Thresholds[LodSelector::MaxLods - 1] = { 0.25f, 0.12f, 0.05f };
+const float32 LodSelector::Hysteresis = 0.15f;
+
+
+float32 LodSelector::
+ProjectedSize(const vec3& center, float32 radius, const vec3& eye, float32 fovY)
+{
+	float32 dist = length(center - eye);
+	if (dist <= radius)
+	{
+		//カメラが球の内側にある
+		return FLT_MAX;
+	}
+	return radius / (dist * tanf(fovY * 0.5f));
+}
+
+uint32 LodSelector::
+Select(float32 projectedSize, uint32 currentLod, uint32 lodCount)
+{
+	if (lodCount <= 1)
+	{
+		return 0;
+	}
+	uint32 lod = (std::min)(currentLod, lodCount - 1);
+
+	//粗いLODへは閾値より十分小さくなってから、細かいLODへは十分大きくなってから切り替える
+	while (lod + 1 < lodCount && projectedSize < Thresholds[lod] * (1.0f - Hysteresis))
+	{
+		++lod;
+	}
+	while (lod > 0 && projectedSize > Thresholds[lod - 1] * (1.0f + Hysteresis))
+	{
+		--lod;
+	}
+	return lod;
+}
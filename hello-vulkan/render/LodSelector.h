@@ -0,0 +1,22 @@
+﻿#pragma once
+
+
+//投影サイズからLODを選ぶ(閾値付近でのちらつきを防ぐヒステリシス付き)
+class LodSelector
+{
+public:
+	static const uint32 MaxLods = 4;
+
+public:
+	//バウンディングスフィアの画面縦方向に対する投影サイズ(直径/画面高さ)
+	static float32
+	ProjectedSize(const glm::vec3& center, float32 radius, const glm::vec3& eye, float32 fovY);
+
+	//現在のLODから、投影サイズに応じた次のLODを返す
+	static uint32
+	Select(float32 projectedSize, uint32 currentLod, uint32 lodCount);
+
+private:
+	static const float32 Thresholds[MaxLods - 1];
+	static const float32 Hysteresis;
+};
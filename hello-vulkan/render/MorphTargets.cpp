@@ -0,0 +1,139 @@
+﻿#include "pch.h"
+#include "MorphTargets.h"
+#include <xmmintrin.h>
+
+using namespace glm;
+
+
+namespace
+{
+	//差分の成分がすべてこれ以下の頂点は動かないものとして捨てる
+	const float32 DeltaEpsilon = 1.0e-7f;
+}
+
+
+MorphTargets::
+MorphTargets()
+: m_ranges(1, Range{ 0, 0 })
+, m_deltas()
+, m_deltaWeights()
+, m_deltaVertices()
+, m_basePositions()
+, m_baseNormals()
+, m_weightCount(0)
+{
+}
+
+void MorphTargets::
+AddTarget(uint32 weight, uint32 firstVertex, uint32 vertexCount, const vec3* positions, const vec3* normals)
+{
+	m_weightCount = (std::max)(m_weightCount, weight + 1);
+	for (uint32 idx=0; idx<vertexCount; ++idx)
+	{
+		vec3 p = (positions != nullptr) ? positions[idx] : vec3(0.0f);
+		vec3 n = (normals != nullptr) ? normals[idx] : vec3(0.0f);
+		if (fabsf(p.x) <= DeltaEpsilon && fabsf(p.y) <= DeltaEpsilon && fabsf(p.z) <= DeltaEpsilon &&
+			fabsf(n.x) <= DeltaEpsilon && fabsf(n.y) <= DeltaEpsilon && fabsf(n.z) <= DeltaEpsilon)
+		{
+			continue;
+		}
+		m_deltas.push_back(Delta{ vec4(p, 0.0f), vec4(n, 0.0f) });
+		m_deltaWeights.push_back(weight);
+		m_deltaVertices.push_back(firstVertex + idx);
+	}
+}
+
+void MorphTargets::
+Build(const void* vertices, uint32 strideBytes)
+{
+	//差分を頂点番号順に並べ替え、同じ頂点の差分を1つの区間にする
+	const uint32 deltaCount = GetDeltaCount();
+	std::vector<uint32> order(deltaCount);
+	for (uint32 idx=0; idx<deltaCount; ++idx)
+	{
+		order[idx] = idx;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](uint32 l, uint32 r) { return m_deltaVertices[l] < m_deltaVertices[r]; });
+
+	std::vector<Delta> deltas(deltaCount);
+	std::vector<uint32> deltaWeights(deltaCount);
+	m_ranges.clear();
+	m_basePositions.clear();
+	m_baseNormals.clear();
+	for (uint32 idx=0; idx<deltaCount; ++idx)
+	{
+		uint32 src = order[idx];
+		uint32 vertex = m_deltaVertices[src];
+		if (m_ranges.empty() || m_ranges.back().vertex != vertex)
+		{
+			m_ranges.push_back(Range{ vertex, idx });
+			auto v = reinterpret_cast<const float32*>(reinterpret_cast<const uint8*>(vertices) + size_t(vertex) * strideBytes);
+			m_basePositions.push_back(vec4(v[0], v[1], v[2], 1.0f));
+			m_baseNormals.push_back(vec4(v[3], v[4], v[5], 0.0f));
+		}
+		deltas[idx] = m_deltas[src];
+		deltaWeights[idx] = m_deltaWeights[src];
+	}
+	m_ranges.push_back(Range{ ~0u, deltaCount });
+	m_deltas.swap(deltas);
+	m_deltaWeights.swap(deltaWeights);
+	m_deltaVertices.clear();
+}
+
+void MorphTargets::
+Clear(void)
+{
+	m_ranges.assign(1, Range{ 0, 0 });
+	m_deltas.clear();
+	m_deltaWeights.clear();
+	m_deltaVertices.clear();
+	m_basePositions.clear();
+	m_baseNormals.clear();
+	m_weightCount = 0;
+}
+
+void MorphTargets::
+Evaluate(const float32* weights, vec4* outPositions, vec4* outNormals) const
+{
+	const uint32 count = Size();
+	for (uint32 v=0; v<count; ++v)
+	{
+		__m128 p = _mm_loadu_ps(&m_basePositions[v].x);
+		__m128 n = _mm_loadu_ps(&m_baseNormals[v].x);
+		for (uint32 d=m_ranges[v].firstDelta; d<m_ranges[v + 1].firstDelta; ++d)
+		{
+			float32 w = weights[m_deltaWeights[d]];
+			if (w == 0.0f)
+			{
+				continue;
+			}
+			__m128 ws = _mm_set1_ps(w);
+			p = _mm_add_ps(p, _mm_mul_ps(ws, _mm_loadu_ps(&m_deltas[d].position.x)));
+			n = _mm_add_ps(n, _mm_mul_ps(ws, _mm_loadu_ps(&m_deltas[d].normal.x)));
+		}
+
+		//法線は長さを1に戻す(wは0なので内積に影響しない)
+		__m128 lenSq = _mm_mul_ps(n, n);
+		lenSq = _mm_add_ps(lenSq, _mm_shuffle_ps(lenSq, lenSq, _MM_SHUFFLE(2, 3, 0, 1)));
+		lenSq = _mm_add_ps(lenSq, _mm_shuffle_ps(lenSq, lenSq, _MM_SHUFFLE(1, 0, 3, 2)));
+		if (_mm_cvtss_f32(lenSq) > 0.0f)
+		{
+			n = _mm_div_ps(n, _mm_sqrt_ps(lenSq));
+		}
+		_mm_storeu_ps(&outPositions[v].x, p);
+		_mm_storeu_ps(&outNormals[v].x, n);
+	}
+}
+
+bool MorphTargets::
+IsZero(const float32* weights, uint32 count)
+{
+	for (uint32 idx=0; idx<count; ++idx)
+	{
+		if (weights[idx] != 0.0f)
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,70 @@
+﻿#pragma once
+
+#include <vector>
+
+
+//モーフターゲット(VRMのブレンドシェイプ)の差分を、実際に動く頂点だけ頂点ごとにまとめて持つ
+//頂点ごとに差分の区間を持つCSR形式なので、1頂点を1スレッドで競合なく足し込める
+class MorphTargets
+{
+public:
+	//頂点ごとの差分の区間
+	struct Range
+	{
+		uint32 vertex;			//モデル全体の頂点番号
+		uint32 firstDelta;		//次の頂点のfirstDeltaまで
+	};
+	//wは0
+	struct Delta
+	{
+		glm::vec4 position;
+		glm::vec4 normal;
+	};
+
+public:
+	MorphTargets();
+
+	//firstVertexから続くvertexCount個の差分のうち、動く頂点だけを取っておく(normalsはnullptrでもよい)
+	//weightはウェイト配列の番号 同じメッシュのプリミティブは同じ番号を共有する
+	void
+	AddTarget(uint32 weight, uint32 firstVertex, uint32 vertexCount, const glm::vec3* positions, const glm::vec3* normals);
+	//追加した差分を頂点ごとにまとめ直し、元の位置・法線をvertices(strideBytes間隔で位置・法線の順)から取っておく
+	void
+	Build(const void* vertices, uint32 strideBytes);
+	void
+	Clear(void);
+
+	//動く頂点の数
+	uint32
+	Size(void) const { return uint32(m_ranges.size()) - 1; }
+	uint32
+	GetDeltaCount(void) const { return uint32(m_deltas.size()); }
+	//ウェイト配列に必要な長さ
+	uint32
+	GetWeightCount(void) const { return m_weightCount; }
+	//Size() + 1個(末尾は番兵)
+	const std::vector<Range>&
+	GetRanges(void) const { return m_ranges; }
+	const std::vector<Delta>&
+	GetDeltas(void) const { return m_deltas; }
+	const std::vector<uint32>&
+	GetDeltaWeights(void) const { return m_deltaWeights; }
+
+	//動く頂点ごとに元の値へウェイト付きの差分を足し、outPositions/outNormals(Size()個)へ書く(SSE)
+	void
+	Evaluate(const float32* weights, glm::vec4* outPositions, glm::vec4* outNormals) const;
+
+public:
+	//ウェイトがすべて0なら評価を省ける
+	static bool
+	IsZero(const float32* weights, uint32 count);
+
+private:
+	std::vector<Range> m_ranges;
+	std::vector<Delta> m_deltas;
+	std::vector<uint32> m_deltaWeights;		//m_deltasと同じ並びのウェイト番号
+	std::vector<uint32> m_deltaVertices;	//Buildまでの差分ごとの頂点番号
+	std::vector<glm::vec4> m_basePositions;
+	std::vector<glm::vec4> m_baseNormals;
+	uint32 m_weightCount;
+};
@@ -0,0 +1,198 @@
+﻿#include "pch.h"
+#include "SceneGraph.h"
+#include <xmmintrin.h>
+#include "job/JobSystem.h"
+
+using namespace glm;
+
+
+SceneGraph::
+SceneGraph()
+: m_parents()
+, m_depths()
+, m_levelStarts()
+, m_translations()
+, m_rotations()
+, m_scales()
+, m_worlds()
+, m_localDirty()
+, m_worldChanged()
+, m_changedNodes()
+, m_firstDirty(InvalidNode)
+{
+}
+
+uint32 SceneGraph::
+AddNode(uint32 parent, const vec3& translation, const quat& rotation, const vec3& scale)
+{
+	uint32 node = Size();
+	parent = (parent < node) ? parent : InvalidNode;
+	uint32 depth = (parent != InvalidNode) ? m_depths[parent] + 1 : 0;
+	if (node == 0 || m_depths[node - 1] != depth)
+	{
+		m_levelStarts.push_back(node);
+	}
+	m_parents.push_back(parent);
+	m_depths.push_back(depth);
+	m_translations.push_back(translation);
+	m_rotations.push_back(rotation);
+	m_scales.push_back(scale);
+	m_worlds.push_back(mat4(1.0f));
+	m_localDirty.push_back(0);
+	m_worldChanged.push_back(0);
+	_MarkDirty(node);
+	return node;
+}
+
+void SceneGraph::
+Clear(void)
+{
+	m_parents.clear();
+	m_depths.clear();
+	m_levelStarts.clear();
+	m_translations.clear();
+	m_rotations.clear();
+	m_scales.clear();
+	m_worlds.clear();
+	m_localDirty.clear();
+	m_worldChanged.clear();
+	m_changedNodes.clear();
+	m_firstDirty = InvalidNode;
+}
+
+void SceneGraph::
+SetTranslation(uint32 node, const vec3& translation)
+{
+	m_translations[node] = translation;
+	_MarkDirty(node);
+}
+
+void SceneGraph::
+SetRotation(uint32 node, const quat& rotation)
+{
+	m_rotations[node] = rotation;
+	_MarkDirty(node);
+}
+
+void SceneGraph::
+SetScale(uint32 node, const vec3& scale)
+{
+	m_scales[node] = scale;
+	_MarkDirty(node);
+}
+
+uint32 SceneGraph::
+Update(JobSystem* jobs)
+{
+	//前回の変更フラグを落とす
+	for (auto node : m_changedNodes)
+	{
+		m_worldChanged[node] = 0;
+	}
+	m_changedNodes.clear();
+	if (m_firstDirty == InvalidNode)
+	{
+		return 0;
+	}
+
+	//親は前の段にあるので、段の順に処理すれば親の変更は子を見る時点で確定している
+	const uint32 count = Size();
+	const bool parallel = (jobs != nullptr && jobs->GetThreadCount() > 1);
+	uint32 level = uint32(std::upper_bound(m_levelStarts.begin(), m_levelStarts.end(), m_firstDirty) - m_levelStarts.begin()) - 1;
+	for (; level<GetLevelCount(); ++level)
+	{
+		uint32 begin = (std::max)(m_levelStarts[level], m_firstDirty);
+		uint32 end = (level + 1 < GetLevelCount()) ? m_levelStarts[level + 1] : count;
+		if (!parallel || end - begin < ChunkNodes * 2)
+		{
+			_UpdateRange(begin, end);
+			continue;
+		}
+		//チャンクの境界がChunkNodesの倍数に来るよう、段の手前の境界から数える
+		uint32 base = begin & ~(ChunkNodes - 1);
+		jobs->ParallelFor(end - base, ChunkNodes, [this, base, begin](uint32 chunkBegin, uint32 chunkEnd) {
+			_UpdateRange((std::max)(base + chunkBegin, begin), base + chunkEnd);
+		});
+	}
+
+	//変更したノードの一覧は並列処理が終わってから集める
+	for (uint32 node=m_firstDirty; node<count; ++node)
+	{
+		if (m_worldChanged[node] != 0)
+		{
+			m_changedNodes.push_back(node);
+		}
+	}
+	m_firstDirty = InvalidNode;
+	return uint32(m_changedNodes.size());
+}
+
+mat4 SceneGraph::
+ComposeTrs(const vec3& t, const quat& r, const vec3& s)
+{
+	float32 xx = r.x * r.x, yy = r.y * r.y, zz = r.z * r.z;
+	float32 xy = r.x * r.y, xz = r.x * r.z, yz = r.y * r.z;
+	float32 wx = r.w * r.x, wy = r.w * r.y, wz = r.w * r.z;
+	mat4 m;
+	m[0] = vec4((1.0f - 2.0f * (yy + zz)) * s.x, 2.0f * (xy + wz) * s.x, 2.0f * (xz - wy) * s.x, 0.0f);
+	m[1] = vec4(2.0f * (xy - wz) * s.y, (1.0f - 2.0f * (xx + zz)) * s.y, 2.0f * (yz + wx) * s.y, 0.0f);
+	m[2] = vec4(2.0f * (xz + wy) * s.z, 2.0f * (yz - wx) * s.z, (1.0f - 2.0f * (xx + yy)) * s.z, 0.0f);
+	m[3] = vec4(t, 1.0f);
+	return m;
+}
+
+void SceneGraph::
+MulMatrix(const mat4& a, const mat4& b, mat4& out)
+{
+	//列優先なので out[c] = a[0]*b[c].x + a[1]*b[c].y + a[2]*b[c].z + a[3]*b[c].w
+	const __m128 a0 = _mm_loadu_ps(&a[0][0]);
+	const __m128 a1 = _mm_loadu_ps(&a[1][0]);
+	const __m128 a2 = _mm_loadu_ps(&a[2][0]);
+	const __m128 a3 = _mm_loadu_ps(&a[3][0]);
+	__m128 col[4];
+	for (uint32 c=0; c<4; ++c)
+	{
+		const __m128 bc = _mm_loadu_ps(&b[c][0]);
+		__m128 r = _mm_mul_ps(a0, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(0, 0, 0, 0)));
+		r = _mm_add_ps(r, _mm_mul_ps(a1, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(1, 1, 1, 1))));
+		r = _mm_add_ps(r, _mm_mul_ps(a2, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(2, 2, 2, 2))));
+		r = _mm_add_ps(r, _mm_mul_ps(a3, _mm_shuffle_ps(bc, bc, _MM_SHUFFLE(3, 3, 3, 3))));
+		col[c] = r;
+	}
+	for (uint32 c=0; c<4; ++c)
+	{
+		_mm_storeu_ps(&out[c][0], col[c]);
+	}
+}
+
+void SceneGraph::
+_UpdateRange(uint32 begin, uint32 end)
+{
+	for (uint32 node=begin; node<end; ++node)
+	{
+		uint32 parent = m_parents[node];
+		bool parentChanged = (parent != InvalidNode) && m_worldChanged[parent] != 0;
+		if (m_localDirty[node] == 0 && !parentChanged)
+		{
+			continue;
+		}
+		auto local = ComposeTrs(m_translations[node], m_rotations[node], m_scales[node]);
+		if (parent != InvalidNode)
+		{
+			MulMatrix(m_worlds[parent], local, m_worlds[node]);
+		}
+		else
+		{
+			m_worlds[node] = local;
+		}
+		m_localDirty[node] = 0;
+		m_worldChanged[node] = 1;
+	}
+}
+
+void SceneGraph::
+_MarkDirty(uint32 node)
+{
+	m_localDirty[node] = 1;
+	m_firstDirty = (std::min)(m_firstDirty, node);
+}
@@ -0,0 +1,92 @@
+﻿#pragma once
+
+#include <vector>
+#include <glm/gtc/quaternion.hpp>
+
+class JobSystem;
+
+
+//ノード階層を親が必ず子より前に来る順に平坦化し、ローカルTRSとワールド行列をSoAで保持する
+//ローカルを変更したノードとその子孫だけを、1回の線形走査で更新する
+//同じ深さのノードが続く区間(段)は互いに依存しないので、段ごとに並列で更新できる
+class SceneGraph
+{
+public:
+	static const uint32 InvalidNode = ~0u;
+	//並列更新の分割単位 ワールド行列1個と変更フラグ64個がそれぞれキャッシュライン1本に収まるよう、
+	//チャンクの境界をノード番号のこの倍数にそろえる
+	static const uint32 ChunkNodes = 64;
+
+public:
+	SceneGraph();
+
+	//parentは追加済みのノード(根ならInvalidNode)
+	uint32
+	AddNode(uint32 parent, const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale);
+	void
+	Clear(void);
+	uint32
+	Size(void) const { return uint32(m_parents.size()); }
+
+	void
+	SetTranslation(uint32 node, const glm::vec3& translation);
+	void
+	SetRotation(uint32 node, const glm::quat& rotation);
+	void
+	SetScale(uint32 node, const glm::vec3& scale);
+
+	//変更のあったノードと子孫のワールド行列を更新し、更新したノード数を返す
+	//jobsを渡すと、チャンク2個分以上ある段をワーカーで分担する
+	uint32
+	Update(JobSystem* jobs = nullptr);
+
+	uint32
+	GetParent(uint32 node) const { return m_parents[node]; }
+	uint32
+	GetDepth(uint32 node) const { return m_depths[node]; }
+	//段の数と、各段の先頭ノード
+	uint32
+	GetLevelCount(void) const { return uint32(m_levelStarts.size()); }
+	uint32
+	GetLevelStart(uint32 level) const { return m_levelStarts[level]; }
+	const glm::vec3&
+	GetTranslation(uint32 node) const { return m_translations[node]; }
+	const glm::quat&
+	GetRotation(uint32 node) const { return m_rotations[node]; }
+	const glm::vec3&
+	GetScale(uint32 node) const { return m_scales[node]; }
+	const glm::mat4&
+	GetWorld(uint32 node) const { return m_worlds[node]; }
+	//直前のUpdateでワールド行列が変わったか
+	bool
+	IsWorldChanged(uint32 node) const { return m_worldChanged[node] != 0; }
+	const std::vector<uint32>&
+	GetChangedNodes(void) const { return m_changedNodes; }
+
+public:
+	//T * R * Sの行列を直接組み立てる
+	static glm::mat4
+	ComposeTrs(const glm::vec3& translation, const glm::quat& rotation, const glm::vec3& scale);
+	//out = a * b をSSEで求める(outはaやbと同じでもよい)
+	static void
+	MulMatrix(const glm::mat4& a, const glm::mat4& b, glm::mat4& out);
+
+private:
+	void
+	_MarkDirty(uint32 node);
+	void
+	_UpdateRange(uint32 begin, uint32 end);
+
+private:
+	std::vector<uint32> m_parents;
+	std::vector<uint32> m_depths;
+	std::vector<uint32> m_levelStarts;	//深さが変わるところで区切った段の先頭
+	std::vector<glm::vec3> m_translations;
+	std::vector<glm::quat> m_rotations;
+	std::vector<glm::vec3> m_scales;
+	std::vector<glm::mat4> m_worlds;
+	std::vector<uint8> m_localDirty;
+	std::vector<uint8> m_worldChanged;
+	std::vector<uint32> m_changedNodes;
+	uint32 m_firstDirty;				//これより前のノードは更新不要
+};
@@ -0,0 +1,85 @@
+﻿#include "pch.h"
+#include "SkinPalette.h"
+#include <xmmintrin.h>
+#include "render/SceneGraph.h"
+
+using namespace glm;
+
+
+SkinPalette::
+SkinPalette()
+: m_jointNodes()
+, m_inverseBinds()
+, m_skinOffsets()
+{
+}
+
+uint32 SkinPalette::
+AddSkin(const std::vector<uint32>& jointNodes, const std::vector<mat4>& inverseBinds)
+{
+	uint32 skin = GetSkinCount();
+	m_skinOffsets.push_back(Size());
+	for (size_t idx=0; idx<jointNodes.size() && Size()<MaxJoints; ++idx)
+	{
+		m_jointNodes.push_back(jointNodes[idx]);
+		m_inverseBinds.push_back((idx < inverseBinds.size()) ? inverseBinds[idx] : mat4(1.0f));
+	}
+	return skin;
+}
+
+void SkinPalette::
+Clear(void)
+{
+	m_jointNodes.clear();
+	m_inverseBinds.clear();
+	m_skinOffsets.clear();
+}
+
+void SkinPalette::
+Compute(const SceneGraph& scene, mat4* out) const
+{
+	const uint32 count = Size();
+	for (uint32 idx=0; idx<count; ++idx)
+	{
+		SceneGraph::MulMatrix(scene.GetWorld(m_jointNodes[idx]), m_inverseBinds[idx], out[idx]);
+	}
+}
+
+void SkinPalette::
+SkinPositions(const mat4* palette, const SkinVertex* skins, const vec3* positions, uint32 count, vec3* out)
+{
+	for (uint32 v=0; v<count; ++v)
+	{
+		const auto& skin = skins[v];
+		const auto& p = positions[v];
+
+		//ウェイトを掛けた関節行列の列を足し合わせる
+		__m128 col[4] = { _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps() };
+		bool skinned = false;
+		for (uint32 k=0; k<MaxInfluences; ++k)
+		{
+			if (skin.weights[k] == 0.0f)
+			{
+				continue;
+			}
+			const mat4& m = palette[skin.joints[k]];
+			const __m128 w = _mm_set1_ps(skin.weights[k]);
+			for (uint32 c=0; c<4; ++c)
+			{
+				col[c] = _mm_add_ps(col[c], _mm_mul_ps(_mm_loadu_ps(&m[c][0]), w));
+			}
+			skinned = true;
+		}
+		if (!skinned)
+		{
+			out[v] = p;
+			continue;
+		}
+
+		__m128 r = _mm_add_ps(_mm_mul_ps(col[0], _mm_set1_ps(p.x)), _mm_mul_ps(col[1], _mm_set1_ps(p.y)));
+		r = _mm_add_ps(r, _mm_add_ps(_mm_mul_ps(col[2], _mm_set1_ps(p.z)), col[3]));
+		alignas(16) float32 result[4];
+		_mm_store_ps(result, r);
+		out[v] = vec3(result[0], result[1], result[2]);
+	}
+}
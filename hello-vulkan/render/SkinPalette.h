@@ -0,0 +1,53 @@
+﻿#pragma once
+
+#include <vector>
+
+class SceneGraph;
+
+
+//スキンごとの関節ノードと逆バインド行列を保持し、全スキンの関節行列を1本の配列(パレット)にまとめる
+//頂点の関節番号は、スキン内の番号にGetSkinOffsetを足したパレット内の番号で持つ
+class SkinPalette
+{
+public:
+	static const uint32 MaxInfluences = 4;
+	static const uint32 MaxJoints = 0x10000;	//関節番号は16bit
+
+	//頂点ごとの関節とウェイト(ModelAppの頂点バインディング2と同じ並び)
+	//ウェイトがすべて0の頂点はスキニングしない
+	struct SkinVertex
+	{
+		uint16 joints[MaxInfluences];
+		float32 weights[MaxInfluences];
+	};
+
+public:
+	SkinPalette();
+
+	//jointNodesはシーンのノード inverseBindsは同じ長さ(空なら単位行列) 戻り値はスキン番号
+	uint32
+	AddSkin(const std::vector<uint32>& jointNodes, const std::vector<glm::mat4>& inverseBinds);
+	void
+	Clear(void);
+	uint32
+	GetSkinCount(void) const { return uint32(m_skinOffsets.size()); }
+	uint32
+	GetSkinOffset(uint32 skin) const { return m_skinOffsets[skin]; }
+	//全スキンの関節数
+	uint32
+	Size(void) const { return uint32(m_jointNodes.size()); }
+
+	//関節のワールド行列×逆バインド行列をout(Size()個)へ書く
+	void
+	Compute(const SceneGraph& scene, glm::mat4* out) const;
+
+public:
+	//CPUで位置をスキニングする(SSE) 計測とコンピュートシェーダーの検証用
+	static void
+	SkinPositions(const glm::mat4* palette, const SkinVertex* skins, const glm::vec3* positions, uint32 count, glm::vec3* out);
+
+private:
+	std::vector<uint32> m_jointNodes;
+	std::vector<glm::mat4> m_inverseBinds;
+	std::vector<uint32> m_skinOffsets;
+};
@@ -0,0 +1,107 @@
+﻿#include "pch.h"
+#include "TransparencyQueue.h"
+
+
+TransparencyQueue::
+TransparencyQueue()
+: m_pushed()
+, m_prevRank()
+, m_prevObjects()
+, m_rankCounts()
+, m_entries()
+, m_scratch()
+, m_sorted()
+{
+}
+
+void TransparencyQueue::
+Clear(void)
+{
+	m_pushed.clear();
+	m_sorted.clear();
+}
+
+void TransparencyQueue::
+Push(uint32 object, float32 depth, uint32 item)
+{
+	//奥ほど先に来るよう、距離のビット列を反転して昇順のキーにする
+	uint32 depthBits = 0;
+	if (depth > 0.0f)
+	{
+		memcpy(&depthBits, &depth, sizeof(depthBits));
+	}
+	m_pushed.push_back(Pushed{ object, item, uint64(~depthBits) << 32 });
+	if (object >= m_prevRank.size())
+	{
+		m_prevRank.resize(object + 1, ~0u);
+	}
+}
+
+void TransparencyQueue::
+Sort(void)
+{
+	const uint32 count = uint32(m_pushed.size());
+	const uint32 prevCount = uint32(m_prevObjects.size());
+
+	//前フレームの順位で並べ、新しく現れた物体は末尾に追加順で置く(順位の計数ソート)
+	m_rankCounts.assign(prevCount + 2, 0);
+	for (const auto& p : m_pushed)
+	{
+		uint32 rank = (std::min)(m_prevRank[p.object], prevCount);
+		++m_rankCounts[rank + 1];
+	}
+	for (uint32 rank=0; rank<=prevCount; ++rank)
+	{
+		m_rankCounts[rank + 1] += m_rankCounts[rank];
+	}
+	m_entries.resize(count);
+	for (uint32 idx=0; idx<count; ++idx)
+	{
+		const auto& p = m_pushed[idx];
+		uint32 rank = (std::min)(m_prevRank[p.object], prevCount);
+		m_entries[m_rankCounts[rank]++] = DrawQueue::Entry{ p.key, idx };
+	}
+
+	//隣同士の逆転が少なければ挿入ソート、多ければ安定な基数ソート
+	uint32 inversions = 0;
+	for (uint32 idx=1; idx<count; ++idx)
+	{
+		inversions += (m_entries[idx - 1].key > m_entries[idx].key) ? 1 : 0;
+	}
+	if (inversions > 0 && inversions <= count / 16 + 1)
+	{
+		for (uint32 idx=1; idx<count; ++idx)
+		{
+			auto e = m_entries[idx];
+			uint32 pos = idx;
+			while (pos > 0 && m_entries[pos - 1].key > e.key)
+			{
+				m_entries[pos] = m_entries[pos - 1];
+				--pos;
+			}
+			m_entries[pos] = e;
+		}
+	}
+	else if (inversions > 0)
+	{
+		DrawQueue::RadixSort(m_entries, m_scratch);
+	}
+
+	//次フレームの入力順のため、今回の順位を覚える
+	for (auto object : m_prevObjects)
+	{
+		m_prevRank[object] = ~0u;
+	}
+	m_prevObjects.clear();
+	m_sorted.resize(count);
+	for (uint32 idx=0; idx<count; ++idx)
+	{
+		const auto& p = m_pushed[m_entries[idx].item];
+		if (m_prevRank[p.object] == ~0u)
+		{
+			m_prevRank[p.object] = uint32(m_prevObjects.size());
+			m_prevObjects.push_back(p.object);
+		}
+		m_sorted[idx] = DrawQueue::Entry{ m_entries[idx].key, p.item };
+	}
+}
@@ -0,0 +1,43 @@
+﻿#pragma once
+
+#include <vector>
+#include "render/DrawQueue.h"
+
+
+//半透明の描画を奥から手前の順に並べる
+//前フレームの並びを入力順に使うので、カメラや物体の動きが小さければほぼ整列済みになる
+class TransparencyQueue
+{
+public:
+	TransparencyQueue();
+
+	void
+	Clear(void);
+	//objectはフレームをまたいで同じ物体を指す番号 同じobjectの描画は追加順にまとまって並ぶ
+	void
+	Push(uint32 object, float32 depth, uint32 item);
+	//奥から手前に並べ替え、次フレーム用に物体の順位を覚える
+	void
+	Sort(void);
+
+	//itemは追加時の値
+	const std::vector<DrawQueue::Entry>&
+	GetEntries(void) const { return m_sorted; }
+
+private:
+	struct Pushed
+	{
+		uint32 object;
+		uint32 item;
+		uint64 key;
+	};
+
+private:
+	std::vector<Pushed> m_pushed;
+	std::vector<uint32> m_prevRank;			//物体ごとの前フレームの順位(~0uは前フレームになし)
+	std::vector<uint32> m_prevObjects;		//前フレームの物体を順位順に
+	std::vector<uint32> m_rankCounts;
+	std::vector<DrawQueue::Entry> m_entries;	//itemはm_pushedの番号
+	std::vector<DrawQueue::Entry> m_scratch;
+	std::vector<DrawQueue::Entry> m_sorted;
+};
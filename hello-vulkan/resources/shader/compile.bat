@@ -2,16 +2,34 @@ rem 
 glslangValidator.exe ezshader.vert -V -S vert -o ezshader.vert.spv
 glslangValidator.exe texshader.vert -V -S vert -o texshader.vert.spv
 glslangValidator.exe texshaderUv.vert -V -S vert -o texshaderUv.vert.spv
+glslangValidator.exe depthOnly.vert -V -S vert -o depthOnly.vert.spv
 glslangValidator.exe ezshader.frag -V -S frag -o ezshader.frag.spv
 glslangValidator.exe texshader.frag -V -S frag -o texshader.frag.spv
 glslangValidator.exe texshaderOpaque.frag -V -S frag -o texshaderOpaque.frag.spv
+glslangValidator.exe texshaderOpaque.frag -V -S frag -DBINDLESS -o texshaderOpaqueBindless.frag.spv
 glslangValidator.exe texshaderAlpha.frag -V -S frag -o texshaderAlpha.frag.spv
+glslangValidator.exe texshaderAlpha.frag -V -S frag -DBINDLESS -o texshaderAlphaBindless.frag.spv
+glslangValidator.exe texshaderSolid.frag -V -S frag -o texshaderSolid.frag.spv
+glslangValidator.exe texshaderSolid.frag -V -S frag -DBINDLESS -o texshaderSolidBindless.frag.spv
+glslangValidator.exe cull.comp -V -S comp -o cull.comp.spv
+glslangValidator.exe hiz.comp -V -S comp -o hiz.comp.spv
+glslangValidator.exe skin.comp -V -S comp -o skin.comp.spv
+glslangValidator.exe morph.comp -V -S comp -o morph.comp.spv
 
 rem \[Xo͐ɃRs[
 copy /Y ezshader.vert.spv ..\..\..\resources\shader\ezshader.vert.spv
 copy /Y texshader.vert.spv ..\..\..\resources\shader\texshader.vert.spv
 copy /Y texshaderUv.vert.spv ..\..\..\resources\shader\texshaderUv.vert.spv
+copy /Y depthOnly.vert.spv ..\..\..\resources\shader\depthOnly.vert.spv
 copy /Y ezshader.frag.spv ..\..\..\resources\shader\ezshader.frag.spv
 copy /Y texshader.frag.spv ..\..\..\resources\shader\texshader.frag.spv
 copy /Y texshaderOpaque.frag.spv ..\..\..\resources\shader\texshaderOpaque.frag.spv
-copy /Y texshaderAlpha.frag.spv ..\..\..\resources\shader\texshaderAlpha.frag.spv
\ No newline at end of file
+copy /Y texshaderOpaqueBindless.frag.spv ..\..\..\resources\shader\texshaderOpaqueBindless.frag.spv
+copy /Y texshaderAlpha.frag.spv ..\..\..\resources\shader\texshaderAlpha.frag.spv
+copy /Y texshaderAlphaBindless.frag.spv ..\..\..\resources\shader\texshaderAlphaBindless.frag.spv
+copy /Y texshaderSolid.frag.spv ..\..\..\resources\shader\texshaderSolid.frag.spv
+copy /Y texshaderSolidBindless.frag.spv ..\..\..\resources\shader\texshaderSolidBindless.frag.spv
+copy /Y cull.comp.spv ..\..\..\resources\shader\cull.comp.spv
+copy /Y hiz.comp.spv ..\..\..\resources\shader\hiz.comp.spv
+copy /Y skin.comp.spv ..\..\..\resources\shader\skin.comp.spv
+copy /Y morph.comp.spv ..\..\..\resources\shader\morph.comp.spv
\ No newline at end of file
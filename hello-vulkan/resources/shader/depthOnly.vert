@@ -0,0 +1,53 @@
+#version 450
+
+//深度プリパス用 位置のみの頂点ストリーム
+layout(location=0) in vec3 inPos;
+// インスタンスごとの入力(バインディング1)
+layout(location=3) in mat4 inInstanceWorld;
+// 関節とウェイト(バインディング2)
+layout(location=8) in uvec4 inJoints;
+layout(location=9) in vec4 inWeights;
+
+// フレームごと(セット0)
+layout(set=0, binding=0) uniform Matrices
+{
+  mat4 world;
+  mat4 view;
+  mat4 proj;
+};
+
+// スキンの関節行列(ワールドまで含む)
+layout(std430, set=0, binding=1) readonly buffer Joints
+{
+  mat4 joints[];
+};
+
+// ノードのワールド行列とスキニングの有無(描画ごとのプッシュ定数)
+layout(push_constant) uniform DrawParams
+{
+  mat4 nodeWorld;
+  uint skinning;
+};
+
+out gl_PerVertex
+{
+  vec4 gl_Position;
+};
+//本描画(EQUAL比較)と同じ深度になるようにする
+invariant gl_Position;
+
+void main()
+{
+  vec4 pos = vec4(inPos, 1.0);
+  if (skinning != 0u && inWeights != vec4(0.0))
+  {
+    mat4 skin =
+      inWeights.x * joints[inJoints.x] +
+      inWeights.y * joints[inJoints.y] +
+      inWeights.z * joints[inJoints.z] +
+      inWeights.w * joints[inJoints.w];
+    pos = skin * pos;
+  }
+  mat4 pvw = proj * view * world;
+  gl_Position = pvw * (inInstanceWorld * (nodeWorld * pos));
+}
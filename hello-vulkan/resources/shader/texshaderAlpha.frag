@@ -1,12 +1,27 @@
 #version 450
+#ifdef BINDLESS
+#extension GL_EXT_nonuniform_qualifier : require
+#endif
 
 layout(location=0) in vec2 inUV;
+layout(location=1) in vec4 inTint;
 layout(location=0) out vec4 outColor;
 
-layout(binding=1) uniform sampler2D diffuseMap;
+#ifdef BINDLESS
+// 全マテリアルのテクスチャ 番号は描画ごとのプッシュ定数で受け取る
+layout(set=1, binding=0) uniform sampler2D diffuseMaps[];
+layout(push_constant) uniform DrawParams
+{
+  layout(offset=68) uint material;
+};
+#define diffuseMap diffuseMaps[material]
+#else
+// マテリアルごと(セット1)
+layout(set=1, binding=0) uniform sampler2D diffuseMap;
+#endif
 
 void main()
 {
-  vec4 color = texture(diffuseMap, inUV);
+  vec4 color = texture(diffuseMap, inUV) * inTint;
   outColor = color;
 }
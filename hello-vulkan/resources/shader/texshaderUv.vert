@@ -3,23 +3,57 @@
 layout(location=0) in vec3 inPos;
 layout(location=1) in vec3 inColor;
 layout(location=2) in vec2 inUV;
+// インスタンスごとの入力(バインディング1)
+layout(location=3) in mat4 inInstanceWorld;
+layout(location=7) in vec4 inInstanceTint;
+// 関節とウェイト(バインディング2)
+layout(location=8) in uvec4 inJoints;
+layout(location=9) in vec4 inWeights;
 layout(location=0) out vec2 outUV;
+layout(location=1) out vec4 outTint;
 
-layout(binding=0) uniform Matrices
+// フレームごと(セット0)
+layout(set=0, binding=0) uniform Matrices
 {
   mat4 world;
   mat4 view;
   mat4 proj;
 };
 
+// スキンの関節行列(ワールドまで含む)
+layout(std430, set=0, binding=1) readonly buffer Joints
+{
+  mat4 joints[];
+};
+
+// ノードのワールド行列とスキニングの有無(描画ごとのプッシュ定数)
+layout(push_constant) uniform DrawParams
+{
+  mat4 nodeWorld;
+  uint skinning;
+};
+
 out gl_PerVertex
 {
   vec4 gl_Position;
 };
+//深度プリパス(depthOnly.vert)と同じ深度になるようにする
+invariant gl_Position;
 
 void main()
 {
+  vec4 pos = vec4(inPos, 1.0);
+  if (skinning != 0u && inWeights != vec4(0.0))
+  {
+    mat4 skin =
+      inWeights.x * joints[inJoints.x] +
+      inWeights.y * joints[inJoints.y] +
+      inWeights.z * joints[inJoints.z] +
+      inWeights.w * joints[inJoints.w];
+    pos = skin * pos;
+  }
   mat4 pvw = proj * view * world;
-  gl_Position = pvw * vec4(inPos, 1.0);
+  gl_Position = pvw * (inInstanceWorld * (nodeWorld * pos));
   outUV = inUV;
+  outTint = inInstanceTint;
 }
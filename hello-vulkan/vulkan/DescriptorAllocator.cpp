@@ -0,0 +1,233 @@
+﻿#include "pch.h"
+#include "DescriptorAllocator.h"
+
+
+namespace
+{
+	//プールごとのセット数は最初の数から倍ずつ増やす
+	const uint32 FirstPoolSets = 8;
+	const uint32 MaxPoolSets = 1024;
+	//1プールのディスクリプタ数の目安(バインドレスの配列のように1セットが大きいレイアウトはセット数を減らす)
+	const uint32 MaxPoolDescriptors = 4096;
+}
+
+
+DescriptorAllocator::
+DescriptorAllocator()
+: m_device()
+, m_layouts()
+, m_layoutCache()
+, m_stats()
+{
+}
+
+DescriptorAllocator::
+~DescriptorAllocator()
+{
+}
+
+void DescriptorAllocator::
+Init(VkDevice device)
+{
+	Destroy();
+	m_device = device;
+}
+
+void DescriptorAllocator::
+Destroy(void)
+{
+	for (auto& v : m_layouts)
+	{
+		auto& entry = v.second;
+		for (auto pool : entry.poolList.pools)
+		{
+			vkDestroyDescriptorPool(m_device, pool, nullptr);
+		}
+		vkDestroyDescriptorSetLayout(m_device, v.first, nullptr);
+	}
+	m_layouts.clear();
+	m_layoutCache.clear();
+	m_stats = Stats{};
+}
+
+VkDescriptorSetLayout DescriptorAllocator::
+GetLayout(const VkDescriptorSetLayoutBinding* bindings, uint32 bindingCount, const VkDescriptorBindingFlagsEXT* bindingFlags)
+{
+	std::vector<BindingKey> key(bindingCount);
+	for (uint32 idx=0; idx<bindingCount; ++idx)
+	{
+		const auto& binding = bindings[idx];
+		key[idx] = BindingKey{ binding.binding, binding.descriptorType, binding.descriptorCount, binding.stageFlags, bindingFlags ? bindingFlags[idx] : 0 };
+	}
+	std::sort(key.begin(), key.end(), [](const BindingKey& a, const BindingKey& b) { return a.binding < b.binding; });
+
+	//ハッシュが同じでもバインディングまで比べる
+	uint64 hash = _Hash(key);
+	auto range = m_layoutCache.equal_range(hash);
+	for (auto it = range.first; it != range.second; ++it)
+	{
+		if (m_layouts[it->second].key == key)
+		{
+			return it->second;
+		}
+	}
+
+	VkDescriptorSetLayoutCreateInfo ci{};
+	ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	ci.bindingCount = bindingCount;
+	ci.pBindings = bindings;
+	VkDescriptorSetLayoutBindingFlagsCreateInfoEXT flagsCi{};
+	flagsCi.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+	flagsCi.bindingCount = bindingCount;
+	flagsCi.pBindingFlags = bindingFlags;
+	ci.pNext = (bindingFlags != nullptr) ? &flagsCi : nullptr;
+	VkDescriptorSetLayout layout = VK_NULL_HANDLE;
+	if (vkCreateDescriptorSetLayout(m_device, &ci, nullptr, &layout) != VK_SUCCESS)
+	{
+		OutputDebugStringA("[DescriptorAllocator] failed to create descriptor set layout\n");
+		return VK_NULL_HANDLE;
+	}
+
+	//プールの大きさはバインディングから種類ごとに足し合わせて決める
+	LayoutEntry entry{};
+	entry.key = key;
+	for (const auto& binding : key)
+	{
+		auto it = std::find_if(entry.sizes.begin(), entry.sizes.end(), [&binding](const VkDescriptorPoolSize& size) { return size.type == binding.type; });
+		if (it != entry.sizes.end())
+		{
+			it->descriptorCount += binding.count;
+		}
+		else
+		{
+			entry.sizes.push_back(VkDescriptorPoolSize{ binding.type, binding.count });
+		}
+	}
+	m_layouts.emplace(layout, std::move(entry));
+	m_layoutCache.emplace(hash, layout);
+	++m_stats.layouts;
+	return layout;
+}
+
+VkDescriptorSet DescriptorAllocator::
+Allocate(VkDescriptorSetLayout layout)
+{
+	auto it = m_layouts.find(layout);
+	if (it == m_layouts.end())
+	{
+		return VK_NULL_HANDLE;
+	}
+	auto& entry = it->second;
+	if (!entry.freeSets.empty())
+	{
+		VkDescriptorSet set = entry.freeSets.back();
+		entry.freeSets.pop_back();
+		++m_stats.recycledSets;
+		return set;
+	}
+	return _Allocate(entry, layout);
+}
+
+void DescriptorAllocator::
+Free(VkDescriptorSetLayout layout, VkDescriptorSet set)
+{
+	auto it = m_layouts.find(layout);
+	if (it != m_layouts.end() && set != VK_NULL_HANDLE)
+	{
+		it->second.freeSets.push_back(set);
+	}
+}
+
+uint64 DescriptorAllocator::
+_Hash(const std::vector<BindingKey>& key)
+{
+	//FNV-1a
+	uint64 hash = 14695981039346656037ull;
+	auto mix = [&hash](uint32 value) {
+		for (uint32 byte=0; byte<4; ++byte)
+		{
+			hash ^= (value >> (byte * 8)) & 0xff;
+			hash *= 1099511628211ull;
+		}
+	};
+	for (const auto& binding : key)
+	{
+		mix(binding.binding);
+		mix(uint32(binding.type));
+		mix(binding.count);
+		mix(binding.stages);
+		mix(binding.flags);
+	}
+	return hash;
+}
+
+VkDescriptorSet DescriptorAllocator::
+_Allocate(LayoutEntry& entry, VkDescriptorSetLayout layout)
+{
+	auto& list = entry.poolList;
+	for (;;)
+	{
+		if (list.current >= uint32(list.pools.size()))
+		{
+			auto pool = _CreatePool(entry, uint32(list.pools.size()));
+			if (pool == VK_NULL_HANDLE)
+			{
+				return VK_NULL_HANDLE;
+			}
+			list.pools.push_back(pool);
+		}
+
+		VkDescriptorSetAllocateInfo ai{};
+		ai.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+		ai.descriptorPool = list.pools[list.current];
+		ai.descriptorSetCount = 1;
+		ai.pSetLayouts = &layout;
+		VkDescriptorSet set = VK_NULL_HANDLE;
+		VkResult result = vkAllocateDescriptorSets(m_device, &ai, &set);
+		if (result == VK_SUCCESS)
+		{
+			++m_stats.allocatedSets;
+			return set;
+		}
+		if (result != VK_ERROR_OUT_OF_POOL_MEMORY && result != VK_ERROR_FRAGMENTED_POOL)
+		{
+			std::stringstream ss;
+			ss << "[DescriptorAllocator] vkAllocateDescriptorSets failed: " << result << "\n";
+			OutputDebugStringA(ss.str().c_str());
+			return VK_NULL_HANDLE;
+		}
+		//満杯なので次のプールへ(無ければより大きいものを作る)
+		++list.current;
+	}
+}
+
+VkDescriptorPool DescriptorAllocator::
+_CreatePool(const LayoutEntry& entry, uint32 index)
+{
+	uint32 largest = 1;
+	for (const auto& size : entry.sizes)
+	{
+		largest = (std::max)(largest, size.descriptorCount);
+	}
+	uint32 setCount = (std::min)(FirstPoolSets << (std::min)(index, 7u), MaxPoolSets);
+	setCount = (std::max)((std::min)(setCount, MaxPoolDescriptors / largest), 1u);
+
+	std::vector<VkDescriptorPoolSize> sizes(entry.sizes);
+	for (auto& size : sizes)
+	{
+		size.descriptorCount *= setCount;
+	}
+	VkDescriptorPoolCreateInfo ci{};
+	ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	ci.maxSets = setCount;
+	ci.poolSizeCount = uint32(sizes.size());
+	ci.pPoolSizes = sizes.data();
+	VkDescriptorPool pool = VK_NULL_HANDLE;
+	if (vkCreateDescriptorPool(m_device, &ci, nullptr, &pool) != VK_SUCCESS)
+	{
+		OutputDebugStringA("[DescriptorAllocator] failed to create descriptor pool\n");
+		return VK_NULL_HANDLE;
+	}
+	++m_stats.pools;
+	return pool;
+}
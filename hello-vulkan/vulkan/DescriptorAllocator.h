@@ -0,0 +1,93 @@
+﻿#ifndef __Vulkan_DescriptorAllocator__
+#define __Vulkan_DescriptorAllocator__
+
+#include <unordered_map>
+#include <vector>
+
+
+//ディスクリプタセットの確保をまとめて受け持つ
+//レイアウトはバインディングのハッシュで使い回し、プールはレイアウトごとに持って足りなくなるたび大きくして足す
+//Freeしたセットは同じレイアウトの次のAllocateでそのまま返す(中身は呼び出し側で書き直す)
+class DescriptorAllocator
+{
+public:
+	struct Stats
+	{
+		uint32 layouts;
+		uint32 pools;
+		uint32 allocatedSets;	//プールから新たに取った数
+		uint32 recycledSets;	//Freeされたものを使い回した数
+	};
+
+public:
+	DescriptorAllocator();
+	~DescriptorAllocator();
+
+	void
+	Init(VkDevice device);
+	//レイアウト・プールをすべて破棄する(デバイスを待った後に呼ぶ)
+	void
+	Destroy(void);
+
+	//同じバインディングで作ったレイアウトがあればそれを返す(Destroyまで持つので呼び出し側で破棄しない)
+	//bindingFlagsはbindingCount個かnullptr 不変サンプラーは扱わない
+	VkDescriptorSetLayout
+	GetLayout(const VkDescriptorSetLayoutBinding* bindings, uint32 bindingCount, const VkDescriptorBindingFlagsEXT* bindingFlags = nullptr);
+
+	//Freeするまで使うセット 失敗したらVK_NULL_HANDLE
+	VkDescriptorSet
+	Allocate(VkDescriptorSetLayout layout);
+	//GPUが使い終わったセットを返す(Destroy後に呼んでも何もしない)
+	void
+	Free(VkDescriptorSetLayout layout, VkDescriptorSet set);
+
+	const Stats&
+	GetStats(void) const { return m_stats; }
+
+private:
+	//レイアウトを比べるためのバインディング1つ分
+	struct BindingKey
+	{
+		uint32 binding;
+		VkDescriptorType type;
+		uint32 count;
+		VkShaderStageFlags stages;
+		VkDescriptorBindingFlagsEXT flags;
+
+		bool
+		operator==(const BindingKey& other) const
+		{
+			return binding == other.binding && type == other.type && count == other.count && stages == other.stages && flags == other.flags;
+		}
+	};
+	//確保を試すプールの並び(currentより前は満杯)
+	struct PoolList
+	{
+		std::vector<VkDescriptorPool> pools;
+		uint32 current;
+	};
+	struct LayoutEntry
+	{
+		std::vector<BindingKey> key;				//binding順
+		std::vector<VkDescriptorPoolSize> sizes;	//1セットあたりの数
+		PoolList poolList;
+		std::vector<VkDescriptorSet> freeSets;
+	};
+
+private:
+	static uint64
+	_Hash(const std::vector<BindingKey>& key);
+	VkDescriptorSet
+	_Allocate(LayoutEntry& entry, VkDescriptorSetLayout layout);
+	//リストのindex番目のプール 後ろほど多くのセットを持つ
+	VkDescriptorPool
+	_CreatePool(const LayoutEntry& entry, uint32 index);
+
+private:
+	VkDevice m_device;
+	std::unordered_map<VkDescriptorSetLayout, LayoutEntry> m_layouts;
+	std::unordered_multimap<uint64, VkDescriptorSetLayout> m_layoutCache;	//バインディングのハッシュから
+	Stats m_stats;
+};
+
+#endif//__Vulkan_DescriptorAllocator__
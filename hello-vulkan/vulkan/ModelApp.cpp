@@ -1,23 +1,169 @@
 #include "pch.h"
 #include "ModelApp.h"
 #include "model/GLTFReader.h"
+#include "model/MeshSimplifier.h"
+#include "model/VertexWelder.h"
 
 
 using namespace glm;
 using namespace std;
 
 
+namespace
+{
+	//ZJ_R}hobt@1{ɐςޕ`搔
+	const uint32 SecondaryChunkDraws = 128;
+	//oChX̃eNX`z̗vf(foCX̏΂ɍ킹)
+	const uint32 BindlessTextureCapacity = 1024;
+	//cull.comp̃fBXNv^(CX^X, `, `搔, LOD, p[^, [xs~bh)
+	const array<VkDescriptorType, 6> CullDescriptorTypes = {
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+		VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER,
+		VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+	};
+
+	//FLOATKꂽ̃ANZT𕂓œǂ
+	vector<float32>
+	ReadNormalizedFloats(const Microsoft::glTF::Document& doc, Microsoft::glTF::GLTFResourceReader& reader, const Microsoft::glTF::Accessor& accessor)
+	{
+		using namespace Microsoft::glTF;
+		vector<float32> result;
+		switch (accessor.componentType)
+		{
+		case COMPONENT_BYTE:
+			for (auto v : reader.ReadBinaryData<int8_t>(doc, accessor))
+			{
+				result.push_back((std::max)(float32(v) / 127.0f, -1.0f));
+			}
+			break;
+		case COMPONENT_UNSIGNED_BYTE:
+			for (auto v : reader.ReadBinaryData<uint8>(doc, accessor))
+			{
+				result.push_back(float32(v) / 255.0f);
+			}
+			break;
+		case COMPONENT_SHORT:
+			for (auto v : reader.ReadBinaryData<int16_t>(doc, accessor))
+			{
+				result.push_back((std::max)(float32(v) / 32767.0f, -1.0f));
+			}
+			break;
+		case COMPONENT_UNSIGNED_SHORT:
+			for (auto v : reader.ReadBinaryData<uint16>(doc, accessor))
+			{
+				result.push_back(float32(v) / 65535.0f);
+			}
+			break;
+		default:
+			result = reader.ReadBinaryData<float32>(doc, accessor);
+			break;
+		}
+		return result;
+	}
+}
+
+
 ModelApp::
 ModelApp()
 : VulkanAppBase()
 , m_model()
+, m_modelReady(false)
+, m_jobs()
+, m_modelLoads()
+, m_modelStates()
+, m_shownModel(0)
+, m_modelFiles()
+, m_modelFile(0)
+, m_swapKeyDown(false)
 , m_uniformBuffers()
-, m_descriptorSetLayout()
-, m_descriptorPool()
+, m_instanceBuffers()
+, m_descriptors()
+, m_frameSetLayout()
+, m_materialSetLayout()
+, m_bindlessEnabled(true)
+, m_bindless(false)
+, m_bindlessCapacity(0)
+, m_frameDescriptorSets()
+, m_textureDescriptorSet()
 , m_sampler()
 , m_pipelineLayout()
 , m_pipelineOpaque()
 , m_pipelineAlpha()
+, m_pipelineDepth()
+, m_pipelineOpaqueEqual()
+, m_pipelineBlend()
+, m_depthPrePass(false)
+, m_prePassKeyDown(false)
+, m_skinningMode(SkinningVertex)
+, m_skinningKeyDown(false)
+, m_morphDemo(false)
+, m_morphKeyDown(false)
+, m_animationPose()
+, m_animationTimes()
+, m_animationCursors()
+, m_animationClip(0)
+, m_animationFadeFrom(~0u)
+, m_animationFade(0.0f)
+, m_animationLastTime(-1.0)
+, m_animationKeyDown(false)
+, m_camera()
+, m_visibleMeshes()
+, m_drawItems()
+, m_drawQueue()
+, m_transparencyQueue()
+, m_drawStats()
+, m_secondaryChunks()
+, m_secondaryKeyDown(false)
+, m_crowdSize(0)
+, m_crowd()
+, m_crowdVisible(0)
+, m_drawRanges()
+, m_meshLods()
+, m_gpuCullingEnabled(false)
+, m_gpuCullingKeyDown(false)
+, m_gpuCulling(false)
+, m_cullParamBuffers()
+, m_cullDescriptorSetLayout()
+, m_cullDescriptorSets()
+, m_cullUploadVersions()
+, m_cullPipelineLayout()
+, m_cullPipeline()
+, m_vkCmdDrawIndexedIndirectCountKHR()
+, m_jointMatrices()
+, m_skinnedBuffersReady()
+, m_skinDescriptorSetLayout()
+, m_skinDescriptorSets()
+, m_skinPipelineLayout()
+, m_skinPipeline()
+, m_skinQueryPool()
+, m_skinQueryWritten()
+, m_skinGpuMs(0.0)
+, m_skinGpuFrames(0)
+, m_morphWeights()
+, m_morphDirty()
+, m_morphPositions()
+, m_morphNormals()
+, m_morphDescriptorSetLayout()
+, m_morphDescriptorSets()
+, m_morphPipelineLayout()
+, m_morphPipeline()
+, m_depthPyramid()
+, m_hizSampler()
+, m_hizDescriptorSetLayout()
+, m_hizDescriptorPool()
+, m_hizDescriptorSets()
+, m_hizPipelineLayout()
+, m_hizPipeline()
+, m_depthHistory(false)
+, m_prevViewProj(1.0f)
+, m_hizReadbackLevel(0)
+, m_hizReadbackBuffers()
+, m_hizReadbackViewProj()
+, m_hizReadbackValid()
+, m_hizBuffer()
 {
 }
 
@@ -29,45 +175,63 @@ ModelApp::
 void ModelApp::
 prepare(void)
 {
-	//fǂݍ
-	wchar exePath[_MAX_PATH];
-	wstring filePath;
-	GetModuleFileName(NULL, exePath, _MAX_PATH);
-	wchar szDir[_MAX_DIR];
-	wchar szDrive[_MAX_DRIVE];
-	_wsplitpath_s(exePath, szDrive, _MAX_DRIVE, szDir, _MAX_DIR, nullptr, 0, nullptr, 0);
-	filePath.assign(szDrive);
-	filePath.append(szDir);
-	filePath.append(L"model\\model2.vrm");
-	auto modelFilePath = experimental::filesystem::path(filePath.c_str());
-	auto reader = make_unique<GLTFReader>(modelFilePath.parent_path());
-	auto glbStream = reader->GetInputStream(modelFilePath.filename().u8string());
-	auto glbResourceReader = make_shared<Microsoft::glTF::GLBResourceReader>(std::move(reader), std::move(glbStream));
-	auto document = Microsoft::glTF::Deserialize(glbResourceReader->GetJson());
+	m_jobs.Start(JobSystem::GetHardwareThreadCount() - 1);
+	_CreateSecondaryCommandPools(m_jobs.GetThreadCount());
 
-	_CreateModelGeometry(document, glbResourceReader);
-	_CreateModelMaterial(document, glbResourceReader);
+	//f̓[J[œǂݍ݁AǂݏIt[`悷(܂ł͔wî)
+	if (m_modelFiles.empty())
+	{
+		m_modelFiles.push_back(L"model\\model2.vrm");
+	}
+	LoadModelAsync(m_modelFiles[m_modelFile].c_str());
 
 	_CreateUniformBuffers();
+	_CreateInstanceBuffers();
+	//oChXł͑S}eÃeNX`1̔zɓA`悲Ƃ̔ԍ̓vbV萔œn
+	//fBXNv^Zbg̃oCh̓R}hobt@Ƃ1ɂȂ
+	//eNX`z̔ԍ̓vbV萔ǂނ̂ŁAIȓYňΑ(nonuniform͗vȂ)
+	if (m_bindlessEnabled && m_vkDeviceFeatures.shaderSampledImageArrayDynamicIndexing
+		&& m_vkDescriptorIndexing.runtimeDescriptorArray && m_vkDescriptorIndexing.descriptorBindingPartiallyBound)
+	{
+		VkPhysicalDeviceProperties deviceProps;
+		vkGetPhysicalDeviceProperties(m_vkPhysicalDevice, &deviceProps);
+		m_bindlessCapacity = (std::min)({ BindlessTextureCapacity, deviceProps.limits.maxPerStageDescriptorSampledImages, deviceProps.limits.maxPerStageDescriptorSamplers });
+		m_bindless = true;
+	}
+	m_descriptors.Init(m_vkDevice);
 	_CreateDescriptorSetLayout();
-	_CreateDescriptorPool();
-
 	m_sampler = _CreateSampler();
-	_CreateDescriptorSet();
+	_CreateDepthPyramid();
+	_CreateComputePipelines();
 
-	//_͐ݒ
-	VkVertexInputBindingDescription inputBinding{ 0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX };
-	array<VkVertexInputAttributeDescription, 3> inputAttribs{
+	//_͐ݒ(oCfBO1̓CX^XƁA2͊֐߁EEFCg)
+	typedef CrowdScene::InstanceData InstanceData;
+	typedef SkinPalette::SkinVertex SkinVertex;
+	array<VkVertexInputBindingDescription, 3> inputBindings{
+		{
+			{ 0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX },
+			{ 1, sizeof(InstanceData), VK_VERTEX_INPUT_RATE_INSTANCE },
+			{ 2, sizeof(SkinVertex), VK_VERTEX_INPUT_RATE_VERTEX },
+		}
+	};
+	array<VkVertexInputAttributeDescription, 10> inputAttribs{
 		{
 			{0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, pos)},
 			{1, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, color)},
 			{2, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, uv)},
+			{3, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(InstanceData, world) + sizeof(vec4) * 0},
+			{4, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(InstanceData, world) + sizeof(vec4) * 1},
+			{5, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(InstanceData, world) + sizeof(vec4) * 2},
+			{6, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(InstanceData, world) + sizeof(vec4) * 3},
+			{7, 1, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(InstanceData, tint)},
+			{8, 2, VK_FORMAT_R16G16B16A16_UINT, offsetof(SkinVertex, joints)},
+			{9, 2, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(SkinVertex, weights)},
 		}
 	};
 	VkPipelineVertexInputStateCreateInfo vertexInputCi{};
 	vertexInputCi.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-	vertexInputCi.vertexBindingDescriptionCount = 1;
-	vertexInputCi.pVertexBindingDescriptions = &inputBinding;
+	vertexInputCi.vertexBindingDescriptionCount = uint32(inputBindings.size());
+	vertexInputCi.pVertexBindingDescriptions = inputBindings.data();
 	vertexInputCi.vertexAttributeDescriptionCount = uint32(inputAttribs.size());
 	vertexInputCi.pVertexAttributeDescriptions = inputAttribs.data();
 
@@ -110,10 +274,15 @@ prepare(void)
 	multisampleCi.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
 
 	//pCvCCAEg
+	VkPushConstantRange pushRange{ VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(DrawParameters) };
 	VkPipelineLayoutCreateInfo pipelineLayoutCi{};
 	pipelineLayoutCi.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-	pipelineLayoutCi.setLayoutCount = 1;
-	pipelineLayoutCi.pSetLayouts = &m_descriptorSetLayout;
+	//Zbg0̓t[AZbg1̓}eA `悲Ƃ̃m[hE}eAԍ̓vbV萔
+	VkDescriptorSetLayout setLayouts[] = { m_frameSetLayout, m_materialSetLayout };
+	pipelineLayoutCi.setLayoutCount = uint32(_countof(setLayouts));
+	pipelineLayoutCi.pSetLayouts = setLayouts;
+	pipelineLayoutCi.pushConstantRangeCount = 1;
+	pipelineLayoutCi.pPushConstantRanges = &pushRange;
 	vkCreatePipelineLayout(m_vkDevice, &pipelineLayoutCi, nullptr, &m_pipelineLayout);
 
 	//sp pCvC̍\z
@@ -146,7 +315,7 @@ prepare(void)
 		vector<VkPipelineShaderStageCreateInfo> shaderStages
 		{
 			_LoadShaderModule(L"shader\\texshaderUv.vert.spv", VK_SHADER_STAGE_VERTEX_BIT),
-			_LoadShaderModule(L"shader\\texshaderOpaque.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT),
+			_LoadShaderModule(m_bindless ? L"shader\\texshaderOpaqueBindless.frag.spv" : L"shader\\texshaderOpaque.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT),
 		};
 		//pCvC\z
 		VkGraphicsPipelineCreateInfo ci{};
@@ -164,243 +333,2880 @@ prepare(void)
 		ci.layout = m_pipelineLayout;
 		vkCreateGraphicsPipelines(m_vkDevice, VK_NULL_HANDLE, 1, &ci, nullptr, &m_pipelineOpaque);
 
-		for (const auto& v : shaderStages)
+		for (const auto& v : shaderStages)
+		{
+			vkDestroyShaderModule(m_vkDevice, v.module, nullptr);
+		}
+	}
+
+	//p pCvC̍\z
+	{
+		//ufBO
+		const auto colorWriteAll = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		VkPipelineColorBlendAttachmentState blendAttachment{};
+		blendAttachment.blendEnable = VK_TRUE;
+		blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+		blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+		blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+		blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+		blendAttachment.colorWriteMask = colorWriteAll;
+		VkPipelineColorBlendStateCreateInfo cbCi{};
+		cbCi.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		cbCi.attachmentCount = 1;
+		cbCi.pAttachments = &blendAttachment;
+
+		//fvXXeVXe[g
+		VkPipelineDepthStencilStateCreateInfo depthStencilCi{};
+		depthStencilCi.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depthStencilCi.depthTestEnable = VK_TRUE;
+		depthStencilCi.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+		depthStencilCi.depthWriteEnable = VK_TRUE;
+		depthStencilCi.stencilTestEnable = VK_FALSE;
+
+		//VF[_[ǂݍ
+		vector<VkPipelineShaderStageCreateInfo> shaderStages
+		{
+			_LoadShaderModule(L"shader\\texshaderUv.vert.spv", VK_SHADER_STAGE_VERTEX_BIT),
+			_LoadShaderModule(m_bindless ? L"shader\\texshaderAlphaBindless.frag.spv" : L"shader\\texshaderAlpha.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT),
+		};
+		//pCvC\z
+		VkGraphicsPipelineCreateInfo ci{};
+		ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		ci.stageCount = uint32(shaderStages.size());
+		ci.pStages = shaderStages.data();
+		ci.pInputAssemblyState = &inputAssemblyCi;
+		ci.pVertexInputState = &vertexInputCi;
+		ci.pRasterizationState = &rasterizerCi;
+		ci.pDepthStencilState = &depthStencilCi;
+		ci.pMultisampleState = &multisampleCi;
+		ci.pViewportState = &viewportCi;
+		ci.pColorBlendState = &cbCi;
+		ci.renderPass = m_renderPass;
+		ci.layout = m_pipelineLayout;
+		vkCreateGraphicsPipelines(m_vkDevice, VK_NULL_HANDLE, 1, &ci, nullptr, &m_pipelineAlpha);
+
+		for (const auto& v : shaderStages)
+		{
+			vkDestroyShaderModule(m_vkDevice, v.module, nullptr);
+		}
+	}
+
+	//(uh)p pCvC̍\z
+	{
+		//ufBO
+		const auto colorWriteAll = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		VkPipelineColorBlendAttachmentState blendAttachment{};
+		blendAttachment.blendEnable = VK_TRUE;
+		blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+		blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+		blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+		blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+		blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+		blendAttachment.colorWriteMask = colorWriteAll;
+		VkPipelineColorBlendStateCreateInfo cbCi{};
+		cbCi.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		cbCi.attachmentCount = 1;
+		cbCi.pAttachments = &blendAttachment;
+
+		//̔BȂ悤[x͏܂Ȃ
+		VkPipelineDepthStencilStateCreateInfo depthStencilCi{};
+		depthStencilCi.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depthStencilCi.depthTestEnable = VK_TRUE;
+		depthStencilCi.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+		depthStencilCi.depthWriteEnable = VK_FALSE;
+		depthStencilCi.stencilTestEnable = VK_FALSE;
+
+		//VF[_[ǂݍ
+		vector<VkPipelineShaderStageCreateInfo> shaderStages
+		{
+			_LoadShaderModule(L"shader\\texshaderUv.vert.spv", VK_SHADER_STAGE_VERTEX_BIT),
+			_LoadShaderModule(m_bindless ? L"shader\\texshaderAlphaBindless.frag.spv" : L"shader\\texshaderAlpha.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT),
+		};
+		//pCvC\z
+		VkGraphicsPipelineCreateInfo ci{};
+		ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		ci.stageCount = uint32(shaderStages.size());
+		ci.pStages = shaderStages.data();
+		ci.pInputAssemblyState = &inputAssemblyCi;
+		ci.pVertexInputState = &vertexInputCi;
+		ci.pRasterizationState = &rasterizerCi;
+		ci.pDepthStencilState = &depthStencilCi;
+		ci.pMultisampleState = &multisampleCi;
+		ci.pViewportState = &viewportCi;
+		ci.pColorBlendState = &cbCi;
+		ci.renderPass = m_renderPass;
+		ci.layout = m_pipelineLayout;
+		vkCreateGraphicsPipelines(m_vkDevice, VK_NULL_HANDLE, 1, &ci, nullptr, &m_pipelineBlend);
+
+		for (const auto& v : shaderStages)
+		{
+			vkDestroyShaderModule(m_vkDevice, v.module, nullptr);
+		}
+	}
+
+	//[xvpXp pCvC̍\z
+	{
+		//ʒû݂̒_Xg[ƃCX^X̍sA֐߁EEFCg
+		array<VkVertexInputBindingDescription, 3> positionBindings{
+			{
+				{ 0, sizeof(vec3), VK_VERTEX_INPUT_RATE_VERTEX },
+				inputBindings[1],
+				inputBindings[2],
+			}
+		};
+		array<VkVertexInputAttributeDescription, 7> positionAttribs{
+			{
+				{0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0},
+				inputAttribs[3],
+				inputAttribs[4],
+				inputAttribs[5],
+				inputAttribs[6],
+				inputAttribs[8],
+				inputAttribs[9],
+			}
+		};
+		VkPipelineVertexInputStateCreateInfo positionInputCi{};
+		positionInputCi.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+		positionInputCi.vertexBindingDescriptionCount = uint32(positionBindings.size());
+		positionInputCi.pVertexBindingDescriptions = positionBindings.data();
+		positionInputCi.vertexAttributeDescriptionCount = uint32(positionAttribs.size());
+		positionInputCi.pVertexAttributeDescriptions = positionAttribs.data();
+
+		//J[͏܂Ȃ
+		VkPipelineColorBlendAttachmentState blendAttachment{};
+		blendAttachment.blendEnable = VK_FALSE;
+		blendAttachment.colorWriteMask = 0;
+		VkPipelineColorBlendStateCreateInfo cbCi{};
+		cbCi.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		cbCi.attachmentCount = 1;
+		cbCi.pAttachments = &blendAttachment;
+
+		//fvXXeVXe[g
+		VkPipelineDepthStencilStateCreateInfo depthStencilCi{};
+		depthStencilCi.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depthStencilCi.depthTestEnable = VK_TRUE;
+		depthStencilCi.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
+		depthStencilCi.depthWriteEnable = VK_TRUE;
+		depthStencilCi.stencilTestEnable = VK_FALSE;
+
+		//VF[_[ǂݍ(tOgVF[_[Ȃ)
+		vector<VkPipelineShaderStageCreateInfo> shaderStages
+		{
+			_LoadShaderModule(L"shader\\depthOnly.vert.spv", VK_SHADER_STAGE_VERTEX_BIT),
+		};
+		//pCvC\z
+		VkGraphicsPipelineCreateInfo ci{};
+		ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		ci.stageCount = uint32(shaderStages.size());
+		ci.pStages = shaderStages.data();
+		ci.pInputAssemblyState = &inputAssemblyCi;
+		ci.pVertexInputState = &positionInputCi;
+		ci.pRasterizationState = &rasterizerCi;
+		ci.pDepthStencilState = &depthStencilCi;
+		ci.pMultisampleState = &multisampleCi;
+		ci.pViewportState = &viewportCi;
+		ci.pColorBlendState = &cbCi;
+		ci.renderPass = m_renderPass;
+		ci.layout = m_pipelineLayout;
+		vkCreateGraphicsPipelines(m_vkDevice, VK_NULL_HANDLE, 1, &ci, nullptr, &m_pipelineDepth);
+
+		for (const auto& v : shaderStages)
+		{
+			vkDestroyShaderModule(m_vkDevice, v.module, nullptr);
+		}
+	}
+
+	//[xvpX̕sp pCvC̍\z
+	{
+		//ufBO
+		const auto colorWriteAll = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+		VkPipelineColorBlendAttachmentState blendAttachment{};
+		blendAttachment.blendEnable = VK_FALSE;
+		blendAttachment.colorWriteMask = colorWriteAll;
+		VkPipelineColorBlendStateCreateInfo cbCi{};
+		cbCi.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+		cbCi.attachmentCount = 1;
+		cbCi.pAttachments = &blendAttachment;
+
+		//vpXŏ[xƈvʂVF[fBO
+		VkPipelineDepthStencilStateCreateInfo depthStencilCi{};
+		depthStencilCi.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+		depthStencilCi.depthTestEnable = VK_TRUE;
+		depthStencilCi.depthCompareOp = VK_COMPARE_OP_EQUAL;
+		depthStencilCi.depthWriteEnable = VK_FALSE;
+		depthStencilCi.stencilTestEnable = VK_FALSE;
+
+		//VF[_[ǂݍ
+		vector<VkPipelineShaderStageCreateInfo> shaderStages
+		{
+			_LoadShaderModule(L"shader\\texshaderUv.vert.spv", VK_SHADER_STAGE_VERTEX_BIT),
+			_LoadShaderModule(m_bindless ? L"shader\\texshaderSolidBindless.frag.spv" : L"shader\\texshaderSolid.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT),
+		};
+		//pCvC\z
+		VkGraphicsPipelineCreateInfo ci{};
+		ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+		ci.stageCount = uint32(shaderStages.size());
+		ci.pStages = shaderStages.data();
+		ci.pInputAssemblyState = &inputAssemblyCi;
+		ci.pVertexInputState = &vertexInputCi;
+		ci.pRasterizationState = &rasterizerCi;
+		ci.pDepthStencilState = &depthStencilCi;
+		ci.pMultisampleState = &multisampleCi;
+		ci.pViewportState = &viewportCi;
+		ci.pColorBlendState = &cbCi;
+		ci.renderPass = m_renderPass;
+		ci.layout = m_pipelineLayout;
+		vkCreateGraphicsPipelines(m_vkDevice, VK_NULL_HANDLE, 1, &ci, nullptr, &m_pipelineOpaqueEqual);
+
+		for (const auto& v : shaderStages)
+		{
+			vkDestroyShaderModule(m_vkDevice, v.module, nullptr);
+		}
+	}
+}
+
+void ModelApp::
+cleanup(void)
+{
+	//ǂݍݒ̃f̓[J[Î҂Ă̂Ă
+	for (auto& load : m_modelLoads)
+	{
+		m_jobs.Wait(load->counter);
+	}
+	m_jobs.Stop();
+	//Ŏ̂Ă̂terminatefoCX҂ɊJ
+	for (auto& load : m_modelLoads)
+	{
+		_DiscardModelLoad(*load);
+	}
+	m_modelLoads.clear();
+
+	for (auto& v : m_uniformBuffers)
+	{
+		vkDestroyBuffer(m_vkDevice, v.buffer, nullptr);
+		vkFreeMemory(m_vkDevice, v.memory, nullptr);
+	}
+	for (auto& v : m_instanceBuffers)
+	{
+		vkDestroyBuffer(m_vkDevice, v.buffer, nullptr);
+		vkFreeMemory(m_vkDevice, v.memory, nullptr);
+	}
+	vkDestroySampler(m_vkDevice, m_sampler, nullptr);
+
+	vkDestroyPipelineLayout(m_vkDevice, m_pipelineLayout, nullptr);
+	vkDestroyPipeline(m_vkDevice, m_pipelineOpaque, nullptr);
+	vkDestroyPipeline(m_vkDevice, m_pipelineAlpha, nullptr);
+	vkDestroyPipeline(m_vkDevice, m_pipelineDepth, nullptr);
+	vkDestroyPipeline(m_vkDevice, m_pipelineOpaqueEqual, nullptr);
+	vkDestroyPipeline(m_vkDevice, m_pipelineBlend, nullptr);
+
+	_DestroyModelResources();
+	_DestroyComputePipelines();
+	m_descriptors.Destroy();
+	_DestroyDepthPyramid();
+}
+
+void ModelApp::
+makePrePassCommand(VkCommandBuffer command)
+{
+	//PL[Ő[xvpX؂ւ
+	bool keyDown = glfwGetKey(m_window, GLFW_KEY_P) == GLFW_PRESS;
+	if (keyDown && !m_prePassKeyDown)
+	{
+		m_depthPrePass = !m_depthPrePass;
+		OutputDebugStringA(m_depthPrePass ? "[ModelApp] depth prepass on\n" : "[ModelApp] depth prepass off\n");
+	}
+	m_prePassKeyDown = keyDown;
+
+	//KL[ŃXLjO𒸓_VF[_[/Rs[gŐ؂ւ
+	keyDown = glfwGetKey(m_window, GLFW_KEY_K) == GLFW_PRESS;
+	if (keyDown && !m_skinningKeyDown)
+	{
+		m_skinningMode = (m_skinningMode == SkinningVertex) ? SkinningCompute : SkinningVertex;
+		OutputDebugStringA(m_skinningMode == SkinningCompute ? "[ModelApp] skinning compute\n" : "[ModelApp] skinning vertex\n");
+	}
+	m_skinningKeyDown = keyDown;
+
+	//ML[Ń[t^[Qbg1f؂ւ
+	keyDown = glfwGetKey(m_window, GLFW_KEY_M) == GLFW_PRESS;
+	if (keyDown && !m_morphKeyDown)
+	{
+		m_morphDemo = !m_morphDemo;
+		OutputDebugStringA(m_morphDemo ? "[ModelApp] morph demo on\n" : "[ModelApp] morph demo off\n");
+	}
+	m_morphKeyDown = keyDown;
+
+	//RL[ŕ`R}h[J[ŃZJ_֋L^邩؂ւ
+	keyDown = glfwGetKey(m_window, GLFW_KEY_R) == GLFW_PRESS;
+	if (keyDown && !m_secondaryKeyDown)
+	{
+		m_secondaryCommands = !m_secondaryCommands;
+		OutputDebugStringA(m_secondaryCommands ? "[ModelApp] secondary command recording on\n" : "[ModelApp] secondary command recording off\n");
+	}
+	m_secondaryKeyDown = keyDown;
+
+	//GL[ŃbṼJORs[g/CPUŐ؂ւ
+	keyDown = glfwGetKey(m_window, GLFW_KEY_G) == GLFW_PRESS;
+	if (keyDown && !m_gpuCullingKeyDown)
+	{
+		m_gpuCullingEnabled = !m_gpuCullingEnabled;
+		OutputDebugStringA(m_gpuCullingEnabled ? "[ModelApp] gpu culling on\n" : "[ModelApp] gpu culling off\n");
+	}
+	m_gpuCullingKeyDown = keyDown;
+
+	//LL[Ŏ̃f𗠂œǂݍ݁AǂݏIt[œւ
+	keyDown = glfwGetKey(m_window, GLFW_KEY_L) == GLFW_PRESS;
+	if (keyDown && !m_swapKeyDown)
+	{
+		m_modelFile = (m_modelFile + 1) % uint32(m_modelFiles.size());
+		auto handle = LoadModelAsync(m_modelFiles[m_modelFile].c_str());
+		std::stringstream ss;
+		ss << "[ModelApp] model " << handle << " loading\n";
+		OutputDebugStringA(ss.str().c_str());
+	}
+	m_swapKeyDown = keyDown;
+
+	//ǂݏIf`֓n(1͉`Ȃ)
+	_PublishLoadedModels(command);
+	if (!m_modelReady)
+	{
+		return;
+	}
+
+	//Aj[Vm[h̃[J֏݁Am[h̃bVEڂ
+	_UpdateAnimation();
+	if (m_model.scene.Update(&m_jobs) > 0)
+	{
+		_UpdateWorldBounds(m_model, false);
+	}
+	_UpdateCamera();
+	_DispatchMorphing(command);
+	_DispatchSkinning(command);
+
+	//Ot[̐[xՕp̃s~bh
+	_ReadBackDepthPyramid();
+	bool occlusion = _BuildDepthPyramid(command);
+	if (_UseGpuCulling())
+	{
+		_DispatchGpuCulling(command, occlusion);
+	}
+
+	//̃t[̐[x͎̃t[Ŏg
+	m_prevViewProj = m_camera.proj * m_camera.view;
+	m_depthHistory = true;
+}
+
+void ModelApp::
+makeCommand(VkCommandBuffer command)
+{
+	m_drawStats = DrawStats{};
+	if (!m_modelReady)
+	{
+		return;
+	}
+	//QO̓CX^XPʂŃJOAbVELODƂɂ܂Ƃ߂ĕ`
+	bool gpuCulling = _UseGpuCulling();
+	if (m_crowdSize > 0)
+	{
+		_CullCrowd();
+	}
+	else
+	{
+		//GPUJO͉珇ɕׂ邽CPUň
+		_CullCpu(gpuCulling);
+	}
+
+	//Rs[gŃXLjOꍇ͈ꎞ_obt@ǂ
+	bool computeSkinning = _UseComputeSkinning();
+	auto vertexBuffer = computeSkinning ? m_model.skinnedVertexBuffers[m_imageIndex].buffer : _GetMorphedVertexBuffer(m_imageIndex);
+	auto positionBuffer = computeSkinning ? m_model.skinnedPositionBuffers[m_imageIndex].buffer : _GetMorphedPositionBuffer(m_imageIndex);
+	if (m_secondaryCommands)
+	{
+		_RecordSecondaryCommands(command, gpuCulling, vertexBuffer, positionBuffer);
+		return;
+	}
+
+	//L̃CfbNXobt@ƃCX^XE֐߂̃obt@1xZbg
+	m_drawStats.descriptorBinds += _BindGeometry(command, m_depthPrePass ? positionBuffer : vertexBuffer);
+
+	//sbV̐[xʒû݂̃Xg[Őɏ
+	const uint32 queueSize = uint32(m_drawQueue.GetEntries().size());
+	if (m_depthPrePass)
+	{
+		BindState depthBound{ VK_NULL_HANDLE, -1, SceneGraph::InvalidNode, DrawStats{} };
+		if (gpuCulling)
+		{
+			_DrawGpuCulled(command, true, depthBound);
+		}
+		else
+		{
+			_DrawCpuCulled(command, true, 0, queueSize, depthBound);
+		}
+		m_drawStats.Add(depthBound.stats);
+
+		VkDeviceSize offset = 0;
+		vkCmdBindVertexBuffers(command, 0, 1, &vertexBuffer, &offset);
+	}
+
+	BindState bound{ VK_NULL_HANDLE, -1, SceneGraph::InvalidNode, DrawStats{} };
+	if (gpuCulling)
+	{
+		_DrawGpuCulled(command, false, bound);
+	}
+	else
+	{
+		_DrawCpuCulled(command, false, 0, queueSize, bound);
+	}
+	m_drawStats.Add(bound.stats);
+
+	//͕šɉO֕`
+	BindState blendBound{ VK_NULL_HANDLE, -1, SceneGraph::InvalidNode, DrawStats{} };
+	_DrawTransparent(command, 0, uint32(m_transparencyQueue.GetEntries().size()), blendBound);
+	m_drawStats.Add(blendBound.stats);
+}
+
+void ModelApp::
+_RecordSecondaryCommands(VkCommandBuffer command, bool gpuCulling, VkBuffer vertexBuffer, VkBuffer positionBuffer)
+{
+	//pXƂɕ`惊Xg`N֕(GPUJO̓oPbgȂ̂1{)
+	//`N̕т̂܂܎sɂȂ
+	m_secondaryChunks.clear();
+	auto addChunks = [this](SecondaryPass pass, uint32 count) {
+		for (uint32 begin=0; begin<count; begin+=SecondaryChunkDraws)
+		{
+			m_secondaryChunks.push_back(SecondaryChunk{ pass, begin, (std::min)(begin + SecondaryChunkDraws, count), VK_NULL_HANDLE, DrawStats{} });
+		}
+	};
+	const uint32 queueSize = uint32(m_drawQueue.GetEntries().size());
+	if (m_depthPrePass)
+	{
+		if (gpuCulling)
+		{
+			m_secondaryChunks.push_back(SecondaryChunk{ SecondaryDepthGpu, 0, 0, VK_NULL_HANDLE, DrawStats{} });
+		}
+		else
+		{
+			addChunks(SecondaryDepthCpu, queueSize);
+		}
+	}
+	if (gpuCulling)
+	{
+		m_secondaryChunks.push_back(SecondaryChunk{ SecondaryMainGpu, 0, 0, VK_NULL_HANDLE, DrawStats{} });
+	}
+	else
+	{
+		addChunks(SecondaryMainCpu, queueSize);
+	}
+	addChunks(SecondaryTransparent, uint32(m_transparencyQueue.GetEntries().size()));
+	if (m_secondaryChunks.empty())
+	{
+		return;
+	}
+
+	//ZJ_͏ԂpȂ̂ŁA`NƂɃobt@Zbg
+	//v[̓XbhƂɕĂ̂ŁAL^ɑ̃XbhƋȂ
+	m_jobs.ParallelFor(uint32(m_secondaryChunks.size()), 1, [&](uint32 begin, uint32 end) {
+		const uint32 thread = JobSystem::GetThreadIndex();
+		for (uint32 idx=begin; idx<end; ++idx)
+		{
+			auto& chunk = m_secondaryChunks[idx];
+			bool depthOnly = (chunk.pass == SecondaryDepthCpu || chunk.pass == SecondaryDepthGpu);
+			chunk.command = _BeginSecondaryCommand(thread);
+			BindState bound{ VK_NULL_HANDLE, -1, SceneGraph::InvalidNode, DrawStats{} };
+			bound.stats.descriptorBinds += _BindGeometry(chunk.command, depthOnly ? positionBuffer : vertexBuffer);
+			switch (chunk.pass)
+			{
+			case SecondaryDepthCpu:
+			case SecondaryMainCpu:
+				_DrawCpuCulled(chunk.command, depthOnly, chunk.begin, chunk.end, bound);
+				break;
+			case SecondaryDepthGpu:
+			case SecondaryMainGpu:
+				_DrawGpuCulled(chunk.command, depthOnly, bound);
+				break;
+			case SecondaryTransparent:
+				_DrawTransparent(chunk.command, chunk.begin, chunk.end, bound);
+				break;
+			}
+			vkEndCommandBuffer(chunk.command);
+			chunk.stats = bound.stats;
+		}
+	});
+
+	std::vector<VkCommandBuffer> commands;
+	commands.reserve(m_secondaryChunks.size());
+	for (const auto& chunk : m_secondaryChunks)
+	{
+		commands.push_back(chunk.command);
+		m_drawStats.Add(chunk.stats);
+	}
+	vkCmdExecuteCommands(command, uint32(commands.size()), commands.data());
+}
+
+/*virtual*/
+void ModelApp::
+reportFrameStats(float64 cpuMs, float64 gpuMs)
+{
+	//vpX̗LŔrł悤Ƀ[hY
+	std::stringstream ss;
+	ss << "[Frame] " << (_UseGpuCulling() ? "gpu-cull" : "cpu-cull") << (m_depthPrePass ? " prepass" : " no-prepass")
+		<< (m_skinningMode == SkinningCompute ? " skin-compute" : " skin-vertex") << (m_bindless ? " bindless" : "");
+	if (m_crowdSize > 0)
+	{
+		ss << " crowd " << m_crowdVisible << "/" << m_crowdSize;
+	}
+	ss << ": cpu " << cpuMs << "ms";
+	if (gpuMs >= 0.0)
+	{
+		ss << " gpu " << gpuMs << "ms";
+	}
+	ss << " draws " << m_drawStats.draws
+		<< " pipeline binds " << m_drawStats.pipelineBinds
+		<< " descriptor binds " << m_drawStats.descriptorBinds;
+	//Rs[gXLjO͑Õ^CX^v璸_̎Ԃo
+	if (m_skinGpuFrames > 0)
+	{
+		uint32 skinnedVertices = 0;
+		for (const auto& range : m_model.skinnedRanges)
+		{
+			skinnedVertices += range.vertexCount;
+		}
+		float64 skinMs = m_skinGpuMs / m_skinGpuFrames;
+		ss << " skin " << skinMs << "ms (" << skinnedVertices << " vertices, " << (skinMs * 1.0e6 / (std::max)(skinnedVertices, 1u)) << "ns/vertex)";
+		m_skinGpuMs = 0.0;
+		m_skinGpuFrames = 0;
+	}
+	ss << std::endl;
+	OutputDebugStringA(ss.str().c_str());
+}
+
+ModelApp::ModelHandle ModelApp::
+LoadModelAsync(const wchar* fileName)
+{
+	wchar exePath[_MAX_PATH];
+	wstring filePath;
+	GetModuleFileName(NULL, exePath, _MAX_PATH);
+	wchar szDir[_MAX_DIR];
+	wchar szDrive[_MAX_DRIVE];
+	_wsplitpath_s(exePath, szDrive, _MAX_DRIVE, szDir, _MAX_DIR, nullptr, 0, nullptr, 0);
+	filePath.assign(szDrive);
+	filePath.append(szDir);
+	filePath.append(fileName);
+
+	unique_ptr<ModelLoad> load(new ModelLoad());
+	load->app = this;
+	load->handle = ModelHandle(m_modelStates.size());
+	load->filePath = filePath;
+	load->failed = false;
+	m_modelStates.push_back(ModelLoading);
+	m_jobs.SpawnBackground(Job{ &ModelApp::_LoadModelJob, load.get(), 0, 0, &load->counter });
+	m_modelLoads.push_back(std::move(load));
+	return m_modelLoads.back()->handle;
+}
+
+ModelApp::ModelState ModelApp::
+GetModelState(ModelHandle handle) const
+{
+	return (handle < m_modelStates.size()) ? m_modelStates[handle] : ModelFailed;
+}
+
+void ModelApp::
+_DispatchGpuCulling(VkCommandBuffer command, bool occlusion)
+{
+	//̃C[W̃obt@֑OʂɓbV̍sʂ(tFX҂ς݂Ȃ̂ŏĂ悢)
+	auto& uploaded = m_cullUploadVersions[m_imageIndex];
+	if (uploaded != m_model.boundsVersion)
+	{
+		auto memory = m_model.cullInstanceBuffers[m_imageIndex].memory;
+		uint8* p;
+		vkMapMemory(m_vkDevice, memory, 0, VK_WHOLE_SIZE, 0, reinterpret_cast<void**>(&p));
+		for (uint32 meshIdx=0; meshIdx<uint32(m_model.cullInstances.size()); ++meshIdx)
+		{
+			if (m_model.cullInstanceVersions[meshIdx] > uploaded)
+			{
+				memcpy(p + sizeof(GpuInstance) * meshIdx, &m_model.cullInstances[meshIdx], sizeof(GpuInstance));
+			}
+		}
+		vkUnmapMemory(m_vkDevice, memory);
+		uploaded = m_model.boundsVersion;
+	}
+
+	//oPbgƂ̕`搔NA
+	auto countBuffer = m_model.drawCountBuffers[m_imageIndex].buffer;
+	vkCmdFillBuffer(command, countBuffer, 0, VK_WHOLE_SIZE, 0);
+	{
+		//Ot[LODԂ݂̏ƃNA҂
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(command, VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	//ƃJAՕ̏n
+	auto frustum = Frustum::FromMatrix(m_camera.proj * m_camera.view);
+	CullParameters params{};
+	for (uint32 idx=0; idx<Frustum::PlaneCount; ++idx)
+	{
+		params.planes[idx] = frustum.planes[idx];
+	}
+	params.eye = vec4(m_camera.eye, tanf(m_camera.fovY * 0.5f));
+	params.config[0] = uint32(m_model.meshes.size());
+	params.config[1] = (m_vkCmdDrawIndexedIndirectCountKHR != nullptr) ? 1 : 0;
+	params.config[2] = occlusion ? 1 : 0;
+	params.prevViewProj = m_prevViewProj;
+	params.hizInfo = vec4(float32(m_swapchainExtent.width), float32(m_swapchainExtent.height), float32(m_depthPyramid.mipExtents.size()), 0.0f);
+	{
+		auto memory = m_cullParamBuffers[m_imageIndex].memory;
+		void* p;
+		vkMapMemory(m_vkDevice, memory, 0, VK_WHOLE_SIZE, 0, &p);
+		memcpy(p, &params, sizeof(params));
+		vkUnmapMemory(m_vkDevice, memory);
+	}
+
+	vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipeline);
+	vkCmdBindDescriptorSets(command, VK_PIPELINE_BIND_POINT_COMPUTE, m_cullPipelineLayout, 0, 1, &m_cullDescriptorSets[m_imageIndex], 0, nullptr);
+	vkCmdDispatch(command, (params.config[0] + 63) / 64, 1, 1);
+
+	{
+		//Ԑڕ`̈ƂēǂޑOɏ݂҂
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT;
+		vkCmdPipelineBarrier(command, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+}
+
+void ModelApp::
+_UpdateCamera(void)
+{
+	m_camera.eye = vec3(0.0f, 1.5f, -1.0f);
+	m_camera.fovY = glm::radians(45.0f);
+	m_camera.view = lookAtRH(m_camera.eye, vec3(0.0f, 1.25f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+	m_camera.proj = perspective(m_camera.fovY, 1280.0f / 720.0f, 0.01f, 100.0f);
+
+	if (m_crowdSize > 0)
+	{
+		//QOŜ΂ߏォ猩낷
+		m_camera.eye = vec3(0.0f, 6.0f, -6.0f);
+		m_camera.view = lookAtRH(m_camera.eye, vec3(0.0f, 1.0f, 12.0f), vec3(0.0f, 1.0f, 0.0f));
+		m_camera.proj = perspective(m_camera.fovY, 1280.0f / 720.0f, 0.01f, 300.0f);
+	}
+
+	//jtH[obt@XV
+	ShaderParameters shaderParam{};
+	shaderParam.mtxWorld = glm::identity<glm::mat4>();
+	shaderParam.mtxView = m_camera.view;
+	shaderParam.mtxProj = m_camera.proj;
+	{
+		auto memory = m_uniformBuffers[m_imageIndex].memory;
+		void* p;
+		vkMapMemory(m_vkDevice, memory, 0, VK_WHOLE_SIZE, 0, &p);
+		memcpy(p, &shaderParam, sizeof(shaderParam));
+		vkUnmapMemory(m_vkDevice, memory);
+	}
+}
+
+void ModelApp::
+_CullCpu(bool blendOnly)
+{
+	using namespace Microsoft::glTF;
+
+	const auto& eye = m_camera.eye;
+	const auto fovY = m_camera.fovY;
+	auto frustum = Frustum::FromMatrix(m_camera.proj * m_camera.view);
+
+	//SbV̋E܂Ƃ߂ĎJO
+	FrustumCuller::Cull(frustum, m_model.bounds, m_visibleMeshes);
+
+	//ǂݖ߂[xs~bhŉBĂ郁bV
+	const HiZBuffer* occlusion = m_hizBuffer.IsValid() ? &m_hizBuffer : nullptr;
+	if (occlusion != nullptr)
+	{
+		auto end = std::remove_if(m_visibleMeshes.begin(), m_visibleMeshes.end(), [&](uint32 meshIdx)
+		{
+			return occlusion->IsOccluded(m_model.bounds.GetMin(meshIdx), m_model.bounds.GetMax(meshIdx));
+		});
+		m_visibleMeshes.erase(end, m_visibleMeshes.end());
+	}
+
+	//sEAt@eXg̓pXEpCvCE}eAE[x̃L[ŁA
+	//͉sŕבւ
+	m_drawItems.clear();
+	m_drawQueue.Clear();
+	m_transparencyQueue.Clear();
+	for (auto meshIdx : m_visibleMeshes)
+	{
+		const auto& mesh = m_model.meshes[meshIdx];
+		const auto& material = m_model.materials[mesh.materialIndex];
+		bool blend = material.alphaMode == ALPHA_BLEND;
+		if (blendOnly && !blend)
+		{
+			continue;
+		}
+		auto boundsCenter = m_model.bounds.GetCenter(meshIdx);
+		auto boundsRadius = m_model.bounds.GetRadius(meshIdx);
+
+		//eTCYLODI
+		auto& lod = m_meshLods[meshIdx];
+		lod = LodSelector::Select(LodSelector::ProjectedSize(boundsCenter, boundsRadius, eye, fovY), lod, uint32(mesh.lods.size()));
+
+		m_drawRanges.clear();
+		//XLbṼbVbg̓oCh|[Y̋EȂ̂ŕĔ肵Ȃ
+		if (lod == 0 && !mesh.skinned)
+		{
+			//bVbgPʂŃJOÂȂΕ`悵Ȃ
+			//ʕ`̃}eA͗ʂ邽ߖ@R[͎gȂ
+			if (ClusterCuller::Cull(frustum, eye, m_model.scene.GetWorld(mesh.node), !material.doubleSided, occlusion, mesh.meshlets, m_drawRanges) == 0)
+			{
+				continue;
+			}
+		}
+		else
+		{
+			m_drawRanges.push_back(DrawRange{ mesh.lods[lod].firstIndex, mesh.lods[lod].indexCount });
+		}
+
+		//r[Ԃ̉s(s͎OA͉`)
+		float32 depth = -(m_camera.view * vec4(boundsCenter, 1.0f)).z;
+		//pCvC̓pXƂ1Ȃ̂ŃpXƓԍg
+		uint32 pass = _GetRenderPass(material.alphaMode);
+		uint64 key = DrawKey::Make(pass, pass, uint32(mesh.materialIndex), depth);
+		for (const auto& range : m_drawRanges)
+		{
+			if (blend)
+			{
+				m_transparencyQueue.Push(meshIdx, depth, uint32(m_drawItems.size()));
+			}
+			else
+			{
+				m_drawQueue.Push(key, uint32(m_drawItems.size()));
+			}
+			m_drawItems.push_back(DrawItem{ material.alphaMode, meshIdx, range.firstIndex, range.indexCount, 0, 1 });
+		}
+	}
+	m_drawQueue.Sort();
+	m_transparencyQueue.Sort();
+}
+
+void ModelApp::
+_CullCrowd(void)
+{
+	using namespace Microsoft::glTF;
+
+	//CX^XLODɕׂăCX^Xobt@֏
+	uint32 lodCount = 1;
+	for (const auto& mesh : m_model.meshes)
+	{
+		lodCount = (std::max)(lodCount, uint32(mesh.lods.size()));
+	}
+	auto frustum = Frustum::FromMatrix(m_camera.proj * m_camera.view);
+	m_crowdVisible = m_crowd.Update(frustum, m_camera.eye, m_camera.fovY, lodCount);
+	if (m_crowdVisible > 0)
+	{
+		auto memory = m_instanceBuffers[m_imageIndex].memory;
+		void* p;
+		vkMapMemory(m_vkDevice, memory, 0, VK_WHOLE_SIZE, 0, &p);
+		memcpy(p, m_crowd.GetInstances().data(), sizeof(CrowdScene::InstanceData) * m_crowdVisible);
+		vkUnmapMemory(m_vkDevice, memory);
+	}
+
+	//bVELODƂɁALOD̃CX^X܂Ƃ߂1ŕ`
+	//̓CX^XƂɕĉ珇ɕ`
+	m_drawItems.clear();
+	m_drawQueue.Clear();
+	m_transparencyQueue.Clear();
+	const uint32 meshCount = uint32(m_model.meshes.size());
+	const auto& instances = m_crowd.GetInstances();
+	for (uint32 meshIdx=0; meshIdx<meshCount; ++meshIdx)
+	{
+		const auto& mesh = m_model.meshes[meshIdx];
+		const auto& material = m_model.materials[mesh.materialIndex];
+		if (material.alphaMode == ALPHA_BLEND)
+		{
+			//̂̔ԍ͌̂ƃbV̑g(Ot[̕тg񂹂悤̂̔ԍŐU)
+			vec4 center(m_model.bounds.GetCenter(meshIdx), 1.0f);
+			for (uint32 slot=0; slot<m_crowdVisible; ++slot)
+			{
+				const auto& inst = instances[slot];
+				const auto& range = mesh.lods[(std::min)(inst.lod, uint32(mesh.lods.size()) - 1)];
+				float32 depth = -(m_camera.view * (inst.world * center)).z;
+				m_transparencyQueue.Push(m_crowd.GetInstanceId(slot) * meshCount + meshIdx, depth, uint32(m_drawItems.size()));
+				m_drawItems.push_back(DrawItem{ material.alphaMode, meshIdx, range.firstIndex, range.indexCount, slot, 1 });
+			}
+			continue;
+		}
+		uint32 pass = _GetRenderPass(material.alphaMode);
+		uint64 key = DrawKey::Make(pass, pass, uint32(mesh.materialIndex), 0.0f);
+		uint32 meshLods = uint32(mesh.lods.size());
+		for (uint32 lod=0; lod<meshLods; ++lod)
+		{
+			//bVȂeLOD͍łeLODł܂Ƃ߂ĕ`
+			uint32 first = m_crowd.GetLodStart(lod);
+			uint32 last = (lod + 1 == meshLods) ? m_crowd.GetLodStart(LodSelector::MaxLods) : m_crowd.GetLodStart(lod + 1);
+			if (first == last)
+			{
+				continue;
+			}
+			m_drawQueue.Push(key, uint32(m_drawItems.size()));
+			m_drawItems.push_back(DrawItem{ material.alphaMode, meshIdx, mesh.lods[lod].firstIndex, mesh.lods[lod].indexCount, first, last - first });
+		}
+	}
+	m_drawQueue.Sort();
+	m_transparencyQueue.Sort();
+}
+
+uint32 ModelApp::
+_BindGeometry(VkCommandBuffer command, VkBuffer vertexBuffer)
+{
+	VkDeviceSize offset = 0;
+	vkCmdBindIndexBuffer(command, m_model.indexBuffer.buffer, offset, VK_INDEX_TYPE_UINT32);
+	vkCmdBindVertexBuffers(command, 0, 1, &vertexBuffer, &offset);
+	vkCmdBindVertexBuffers(command, 1, 1, &m_instanceBuffers[m_imageIndex].buffer, &offset);
+	vkCmdBindVertexBuffers(command, 2, 1, &m_model.skinBuffer.buffer, &offset);
+
+	//pCvCׂ͂ēCAEgȂ̂ŁApCvCɃZbgĂ
+	//oChXł̓eNX`z̃Zbg11xZbg
+	VkDescriptorSet descriptorSets[] = {
+		m_frameDescriptorSets[m_imageIndex],
+		m_textureDescriptorSet,
+	};
+	uint32 setCount = m_bindless ? 2 : 1;
+	vkCmdBindDescriptorSets(command, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, setCount, descriptorSets, 0, nullptr);
+	return 1;
+}
+
+void ModelApp::
+_BindMaterial(VkCommandBuffer command, int32 material)
+{
+	vkCmdBindDescriptorSets(command, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 1, 1, &m_model.materials[material].descriptorSet, 0, nullptr);
+}
+
+void ModelApp::
+_DrawCpuCulled(VkCommandBuffer command, bool depthOnly, uint32 begin, uint32 end, BindState& bound)
+{
+	//\[gς݂̕тŁAԂςƂoCh
+	//[xvpXł͕ŝ݂`悷
+	const auto& entries = m_drawQueue.GetEntries();
+	for (uint32 idx=begin; idx<end; ++idx)
+	{
+		const auto& item = m_drawItems[entries[idx].item];
+		if (depthOnly && item.mode != Microsoft::glTF::ALPHA_OPAQUE)
+		{
+			continue;
+		}
+		_RecordDrawItem(command, item, depthOnly, bound);
+	}
+}
+
+void ModelApp::
+_DrawTransparent(VkCommandBuffer command, uint32 begin, uint32 end, BindState& bound)
+{
+	const auto& entries = m_transparencyQueue.GetEntries();
+	for (uint32 idx=begin; idx<end; ++idx)
+	{
+		_RecordDrawItem(command, m_drawItems[entries[idx].item], false, bound);
+	}
+}
+
+void ModelApp::
+_RecordDrawItem(VkCommandBuffer command, const DrawItem& item, bool depthOnly, BindState& bound)
+{
+	const auto& mesh = m_model.meshes[item.meshIndex];
+
+	//[hɉăpCvCύX
+	auto pipeline = depthOnly ? m_pipelineDepth : _SelectPipeline(item.mode);
+	if (pipeline != bound.pipeline)
+	{
+		vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+		bound.pipeline = pipeline;
+		++bound.stats.pipelineBinds;
+	}
+
+	//}eAςƂZbg1ւ([x݂̂̓eNX`ǂ܂Ȃ)
+	//oChXł_BindGeometryŃZbgς݂ŁA}eA̓vbV萔Ő؂ւ
+	bool pushParameters = (mesh.node != bound.node);
+	if (!depthOnly && mesh.materialIndex != bound.material)
+	{
+		if (m_bindless)
+		{
+			pushParameters = true;
+		}
+		else
+		{
+			_BindMaterial(command, mesh.materialIndex);
+			++bound.stats.descriptorBinds;
+		}
+		bound.material = mesh.materialIndex;
+	}
+
+	if (pushParameters)
+	{
+		_PushDrawParameters(command, mesh.node, mesh.materialIndex);
+		bound.node = mesh.node;
+	}
+
+	//bVbg͈̔͂Ƃɕ`
+	vkCmdDrawIndexed(command, item.indexCount, item.instanceCount, item.firstIndex, int32(mesh.vertexOffset), item.firstInstance);
+	++bound.stats.draws;
+}
+
+void ModelApp::
+_DrawGpuCulled(VkCommandBuffer command, bool depthOnly, BindState& bound)
+{
+	//Rs[gŋl߂`oPbgƂ1ŕ`悷
+	//[xvpXł͕soPbĝ
+	//oPbg_DrawTransparentŉ珇ɕ`
+	auto indirectBuffer = m_model.indirectBuffers[m_imageIndex].buffer;
+	auto countBuffer = m_model.drawCountBuffers[m_imageIndex].buffer;
+	const uint32 stride = sizeof(VkDrawIndexedIndirectCommand);
+	for (uint32 idx=0; idx<uint32(m_model.drawBuckets.size()); ++idx)
+	{
+		const auto& bucket = m_model.drawBuckets[idx];
+		if ((depthOnly && bucket.mode != Microsoft::glTF::ALPHA_OPAQUE) || bucket.mode == Microsoft::glTF::ALPHA_BLEND)
+		{
+			continue;
+		}
+		auto pipeline = depthOnly ? m_pipelineDepth : _SelectPipeline(bucket.mode);
+		if (pipeline != bound.pipeline)
+		{
+			vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+			bound.pipeline = pipeline;
+			++bound.stats.pipelineBinds;
+		}
+		//oPbg̓}eAEm[h }eA΃Zbg1͂̂܂܎g
+		const auto& mesh = m_model.meshes[bucket.meshIndex];
+		if (!m_bindless && !depthOnly && mesh.materialIndex != bound.material)
+		{
+			_BindMaterial(command, mesh.materialIndex);
+			bound.material = mesh.materialIndex;
+			++bound.stats.descriptorBinds;
+		}
+		//oPbg̃bV͓m[hɑ
+		_PushDrawParameters(command, mesh.node, mesh.materialIndex);
+
+		VkDeviceSize offset = VkDeviceSize(bucket.drawBase) * stride;
+		if (m_vkCmdDrawIndexedIndirectCountKHR != nullptr)
+		{
+			m_vkCmdDrawIndexedIndirectCountKHR(command, indirectBuffer, offset, countBuffer, idx * sizeof(uint32), bucket.capacity, stride);
+			++bound.stats.draws;
+		}
+		else if (m_vkDeviceFeatures.multiDrawIndirect)
+		{
+			//̈instanceCount=0ɂȂĂ
+			vkCmdDrawIndexedIndirect(command, indirectBuffer, offset, bucket.capacity, stride);
+			++bound.stats.draws;
+		}
+		else
+		{
+			for (uint32 draw=0; draw<bucket.capacity; ++draw)
+			{
+				vkCmdDrawIndexedIndirect(command, indirectBuffer, offset + VkDeviceSize(draw) * stride, 1, stride);
+			}
+			bound.stats.draws += bucket.capacity;
+		}
+	}
+}
+
+void ModelApp::
+_PushDrawParameters(VkCommandBuffer command, uint32 node, int32 material)
+{
+	//zɓ肫Ȃ}eA͐擪̃eNX`ŕ`
+	uint32 textureIndex = (uint32(material) < m_bindlessCapacity) ? uint32(material) : 0;
+	DrawParameters params{ m_model.scene.GetWorld(node), _UseComputeSkinning() ? 0u : 1u, textureIndex, {} };
+	vkCmdPushConstants(command, m_pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(params), &params);
+}
+
+bool ModelApp::
+_UseComputeSkinning(void) const
+{
+	return m_skinningMode == SkinningCompute && m_skinPipeline != VK_NULL_HANDLE && !m_skinDescriptorSets.empty();
+}
+
+bool ModelApp::
+_UseGpuCulling(void) const
+{
+	//QO̓CX^XPʂCPUŃJO
+	return m_gpuCullingEnabled && m_gpuCulling && m_crowdSize == 0;
+}
+
+VkPipeline ModelApp::
+_SelectPipeline(Microsoft::glTF::AlphaMode mode) const
+{
+	switch (mode)
+	{
+	case Microsoft::glTF::ALPHA_MASK:
+		return m_pipelineAlpha;
+	case Microsoft::glTF::ALPHA_OPAQUE:
+		//vpXς݂̐[xƈvʂ`
+		return m_depthPrePass ? m_pipelineOpaqueEqual : m_pipelineOpaque;
+	case Microsoft::glTF::ALPHA_BLEND:
+		return m_pipelineBlend;
+	default:
+		return m_pipelineOpaque;
+	}
+}
+
+uint32 ModelApp::
+_GetRenderPass(Microsoft::glTF::AlphaMode mode)
+{
+	//sAt@eXg̏ɕ`
+	switch (mode)
+	{
+	case Microsoft::glTF::ALPHA_OPAQUE:
+		return 0;
+	case Microsoft::glTF::ALPHA_MASK:
+		return 1;
+	case Microsoft::glTF::ALPHA_BLEND:
+	default:
+		return 2;
+	}
+}
+
+void ModelApp::
+_LoadModelJob(void* data, uint32, uint32)
+{
+	//wĩWu ModelLoad̊Oւ͏Ȃ
+	auto& load = *reinterpret_cast<ModelLoad*>(data);
+	auto& app = *load.app;
+	auto& model = load.model;
+	//glTF SDK͉ꂽt@CŗO𓊂̂ŁA[J[̊O֏oɎsƂĕԂ
+	try
+	{
+		auto modelFilePath = experimental::filesystem::path(load.filePath.c_str());
+		if (!experimental::filesystem::exists(modelFilePath))
+		{
+			load.failed = true;
+			return;
+		}
+		auto reader = make_unique<GLTFReader>(modelFilePath.parent_path());
+		auto glbStream = reader->GetInputStream(modelFilePath.filename().u8string());
+		auto glbResourceReader = make_shared<Microsoft::glTF::GLBResourceReader>(std::move(reader), std::move(glbStream));
+		auto document = Microsoft::glTF::Deserialize(glbResourceReader->GetJson());
+
+		//摜̓Xg[ǂނƂ܂łōς܂AfR[h̓}eAƂ̃Wuɕ
+		app._CreateModelMaterial(model, document, glbResourceReader, load.images);
+		load.uploads.resize(model.materials.size());
+		for (uint32 idx=0; idx<uint32(model.materials.size()); ++idx)
+		{
+			app.m_jobs.SpawnBackground(Job{ &ModelApp::_DecodeTextureJob, &load, idx, idx + 1, &load.counter });
+		}
+
+		vector<uint32> nodeMap, meshNodes;
+		vector<int32> meshSkins;
+		app._CreateSceneGraph(model, document, nodeMap, meshNodes, meshSkins);
+		app._CreateSkins(model, document, glbResourceReader, nodeMap);
+		app._CreateAnimations(model, document, glbResourceReader, nodeMap);
+		app._CreateModelGeometry(model, document, glbResourceReader, meshNodes, meshSkins);
+		model.scene.Update();
+		app._UpdateWorldBounds(model, true);
+		app._CreateGpuCullingBuffers(model);
+		app._CreateMorphingBuffers(model);
+		app._CreateSkinningBuffers(model);
+	}
+	catch (const std::exception& e)
+	{
+		std::stringstream ss;
+		ss << "[ModelApp] model " << load.handle << ": " << e.what() << "\n";
+		OutputDebugStringA(ss.str().c_str());
+		load.failed = true;
+	}
+	catch (...)
+	{
+		load.failed = true;
+	}
+}
+
+void ModelApp::
+_DecodeTextureJob(void* data, uint32 begin, uint32 end)
+{
+	auto& load = *reinterpret_cast<ModelLoad*>(data);
+	for (uint32 idx=begin; idx<end; ++idx)
+	{
+		try
+		{
+			load.model.materials[idx].texture = load.app->_CreateTextureFromMemory(load.images[idx], load.uploads[idx]);
+			if (load.model.materials[idx].texture.image == VK_NULL_HANDLE)
+			{
+				std::stringstream ss;
+				ss << "[ModelApp] model " << load.handle << " (" << experimental::filesystem::path(load.filePath).filename().u8string()
+					<< "): failed to decode texture of material " << idx << "\n";
+				OutputDebugStringA(ss.str().c_str());
+				load.failed = true;
+			}
+		}
+		catch (...)
+		{
+			load.failed = true;
+		}
+		vector<char>().swap(load.images[idx]);
+	}
+}
+
+void ModelApp::
+_PublishLoadedModels(VkCommandBuffer command)
+{
+	for (auto it = m_modelLoads.begin(); it != m_modelLoads.end(); )
+	{
+		//JE^[0ȂA[J[ׂ̂͂ẴXbh猩
+		auto& load = **it;
+		if (!load.counter.IsDone())
+		{
+			++it;
+			continue;
+		}
+		std::stringstream ss;
+		if (load.failed)
+		{
+			ss << "[ModelApp] model " << load.handle << " load failed\n";
+			_DiscardModelLoad(load);
+			m_modelStates[load.handle] = ModelFailed;
+		}
+		else if (m_modelReady && load.handle < m_shownModel)
+		{
+			//ォ痊񂾂̂ɕ\Ă
+			ss << "[ModelApp] model " << load.handle << " superseded\n";
+			_DiscardModelLoad(load);
+			m_modelStates[load.handle] = ModelRetired;
+		}
+		else
+		{
+			//`惊Xg͂ŊۂƓւA\̂GPUgIĂJ
+			if (m_modelReady)
+			{
+				_DestroyModelResources();
+				m_modelStates[m_shownModel] = ModelRetired;
+				m_depthHistory = false;
+			}
+			//eNX`̓]͂̃t[̐擪ɐςނ̂ŁA`ɏI
+			vector<BufferObj> staging;
+			for (uint32 idx=0; idx<uint32(load.uploads.size()); ++idx)
+			{
+				_RecordTextureUpload(command, load.model.materials[idx].texture, load.uploads[idx]);
+				staging.push_back(load.uploads[idx].staging);
+			}
+			_RetireBuffers(staging);
+			m_model = std::move(load.model);
+			_CreateModelResources();
+			m_modelReady = true;
+			m_shownModel = load.handle;
+			m_modelStates[load.handle] = ModelReady;
+			ss << "[ModelApp] model " << load.handle << " ready: " << m_model.meshes.size() << " meshes, "
+				<< m_model.materials.size() << " materials, " << m_model.vertexCount << " vertices\n";
+		}
+		OutputDebugStringA(ss.str().c_str());
+		it = m_modelLoads.erase(it);
+	}
+}
+
+void ModelApp::
+_DiscardModelLoad(ModelLoad& load)
+{
+	vector<BufferObj> staging;
+	for (const auto& upload : load.uploads)
+	{
+		staging.push_back(upload.staging);
+	}
+	_RetireBuffers(staging);
+	_DestroyModel(load.model);
+}
+
+void ModelApp::
+_CreateModelResources(void)
+{
+	//`Xbh̏Ԃƃt[Ƃ̎m_modelɍ킹č
+	m_meshLods.assign(m_model.meshes.size(), 0);
+	m_animationTimes.assign(m_model.clips.size(), 0.0f);
+	m_animationCursors.resize(m_model.clips.size());
+	for (size_t idx=0; idx<m_model.clips.size(); ++idx)
+	{
+		m_animationCursors[idx].assign(m_model.clips[idx].GetTrackCount(), 0);
+	}
+	m_animationClip = 0;
+	m_animationFadeFrom = ~0u;
+
+	//QO̓fŜ̋EŔzuEJO
+	if (m_crowdSize > 0)
+	{
+		vec3 minPos(FLT_MAX), maxPos(-FLT_MAX);
+		for (uint32 idx=0; idx<m_model.bounds.Size(); ++idx)
+		{
+			minPos = glm::min(minPos, m_model.bounds.GetMin(idx));
+			maxPos = glm::max(maxPos, m_model.bounds.GetMax(idx));
+		}
+		m_crowd.Build(m_crowdSize, (minPos + maxPos) * 0.5f, length(maxPos - minPos) * 0.5f);
+	}
+
+	_CreateMorphing();
+	_CreateSkinning();
+	_CreateDescriptorSet();
+	_CreateGpuCulling();
+}
+
+void ModelApp::
+_DestroyModel(Model& model)
+{
+	//fBXNv^Zbg_DestroyModelResourcesŃAP[^[֕Ԃ
+	vector<BufferObj> buffers{ model.vertexBuffer, model.positionBuffer, model.indexBuffer, model.skinBuffer,
+		model.cullLodStateBuffer, model.morphRangeBuffer, model.morphDeltaBuffer };
+	for (const auto* frameBuffers : { &model.cullInstanceBuffers, &model.indirectBuffers, &model.drawCountBuffers, &model.jointBuffers, &model.skinnedVertexBuffers,
+		&model.skinnedPositionBuffers, &model.morphVertexBuffers, &model.morphPositionBuffers, &model.morphWeightBuffers })
+	{
+		buffers.insert(buffers.end(), frameBuffers->begin(), frameBuffers->end());
+	}
+	_RetireBuffers(buffers);
+	auto device = m_vkDevice;
+	vector<TextureObj> textures;
+	for (const auto& material : model.materials)
+	{
+		textures.push_back(material.texture);
+	}
+	_RetireResource([device, textures]()
+	{
+		for (const auto& v : textures)
+		{
+			vkDestroyImageView(device, v.view, nullptr);
+			vkDestroyImage(device, v.image, nullptr);
+			vkFreeMemory(device, v.memory, nullptr);
+		}
+	});
+	model = Model();
+}
+
+void ModelApp::
+_DestroyModelResources(void)
+{
+	_DestroyGpuCulling();
+	_DestroySkinning();
+	_DestroyMorphing();
+
+	vector<VkDescriptorSet> materialSets;
+	if (m_textureDescriptorSet != VK_NULL_HANDLE)
+	{
+		materialSets.push_back(m_textureDescriptorSet);
+	}
+	for (const auto& material : m_model.materials)
+	{
+		if (material.descriptorSet != VK_NULL_HANDLE)
+		{
+			materialSets.push_back(material.descriptorSet);
+		}
+	}
+	_RetireDescriptorSets(m_frameSetLayout, m_frameDescriptorSets);
+	_RetireDescriptorSets(m_materialSetLayout, materialSets);
+	m_frameDescriptorSets.clear();
+	m_textureDescriptorSet = VK_NULL_HANDLE;
+	_DestroyModel(m_model);
+	m_modelReady = false;
+}
+
+void ModelApp::
+_RetireBuffers(const std::vector<BufferObj>& buffers)
+{
+	auto device = m_vkDevice;
+	_RetireResource([device, buffers]()
+	{
+		for (const auto& v : buffers)
+		{
+			vkDestroyBuffer(device, v.buffer, nullptr);
+			vkFreeMemory(device, v.memory, nullptr);
+		}
+	});
+}
+
+void ModelApp::
+_RetireDescriptorSets(VkDescriptorSetLayout layout, const std::vector<VkDescriptorSet>& sets)
+{
+	//GPUgIĂAP[^[֕ԂÃfŏĎg
+	auto descriptors = &m_descriptors;
+	_RetireResource([descriptors, layout, sets]()
+	{
+		for (auto v : sets)
+		{
+			descriptors->Free(layout, v);
+		}
+	});
+}
+
+void ModelApp::
+_CreateModelGeometry(Model& model, const Microsoft::glTF::Document& doc, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader, const std::vector<uint32>& meshNodes, const std::vector<int32>& meshSkins)
+{
+	using namespace Microsoft::glTF;
+	//̋ȓ̒_͓Ƃ݂Ȃ
+	const float32 weldEpsilon = 1.0e-6f;
+
+	//[t^[Qbg̎QƐ悪
+	auto sameTargets = [](const MeshPrimitive& a, const MeshPrimitive& b)
+	{
+		if (a.targets.size() != b.targets.size())
+		{
+			return false;
+		}
+		for (size_t idx=0; idx<a.targets.size(); ++idx)
+		{
+			if (a.targets[idx].positionsAccessorId != b.targets[idx].positionsAccessorId ||
+				a.targets[idx].normalsAccessorId != b.targets[idx].normalsAccessorId)
+			{
+				return false;
+			}
+		}
+		return true;
+	};
+
+	std::vector<Vertex> arenaVertices;
+	std::vector<SkinPalette::SkinVertex> arenaSkins;
+	std::vector<uint32> arenaIndices;
+	model.morphs.Clear();
+	model.morphWeights.clear();
+	for (size_t meshIdx=0; meshIdx<doc.meshes.Size(); ++meshIdx)
+	{
+		const auto& mesh = doc.meshes.Elements()[meshIdx];
+		size_t firstModelMesh = model.meshes.size();
+		int32 skin = meshSkins[meshIdx];
+		bool meshSkinned = false;
+		//bṼ^[Qbg̓v~eBuԂŋʂ̃EFCgg
+		const uint32 morphBase = uint32(model.morphWeights.size());
+		uint32 meshTargets = uint32(mesh.weights.size());
+		//_ANZTQƂv~eBu͒_L
+		std::vector<bool> loaded(mesh.primitives.size(), false);
+		for (size_t first=0; first<mesh.primitives.size(); ++first)
+		{
+			if (loaded[first])
+			{
+				continue;
+			}
+			std::vector<Vertex> vertices;
+
+			//_ʒu擾
+			const auto& basePrimitive = mesh.primitives[first];
+			auto& idPos = basePrimitive.GetAttributeAccessorId(ACCESSOR_POSITION);
+			auto& accPos = doc.accessors.Get(idPos);
+			//@̎擾
+			auto& idNrm = basePrimitive.GetAttributeAccessorId(ACCESSOR_NORMAL);
+			auto& accNrm = doc.accessors.Get(idNrm);
+			//UVW̎擾
+			auto& idUv = basePrimitive.GetAttributeAccessorId(ACCESSOR_TEXCOORD_0);
+			auto& accUv = doc.accessors.Get(idUv);
+			//֐߁EEFCg(XLm[hQƂƂ̂)
+			std::string idJoints, idWeights;
+			bool skinned = skin >= 0 &&
+				basePrimitive.TryGetAttributeAccessorId(ACCESSOR_JOINTS_0, idJoints) &&
+				basePrimitive.TryGetAttributeAccessorId(ACCESSOR_WEIGHTS_0, idWeights);
+
+			//f[^擾
+			auto vertPos = reader->ReadBinaryData<float32>(doc, accPos);
+			auto vertNrm = reader->ReadBinaryData<float32>(doc, accNrm);
+			auto vertUv = reader->ReadBinaryData<float32>(doc, accUv);
+
+			auto vertCount = accPos.count;
+			for (uint32 idx=0; idx<vertCount; ++idx)
+			{
+				//_f[^̍\z
+				int32 vid0 = 3 * idx, vid1 = 3 * idx + 1, vid2 = 3 * idx + 2;
+				int32 tid0 = 2 * idx, tid1 = 2 * idx + 1;
+				vertices.emplace_back(
+					Vertex{
+						vec3(vertPos[vid0], vertPos[vid1], vertPos[vid2]),
+						vec3(vertNrm[vid0], vertNrm[vid1], vertNrm[vid2]),
+						vec2(vertUv[tid0], vertUv[tid1])
+					}
+				);
+			}
+
+			std::vector<SkinPalette::SkinVertex> skinVertices(vertices.size(), SkinPalette::SkinVertex{});
+			if (skinned)
+			{
+				_ReadSkinVertices(doc, reader, basePrimitive, model.skins.GetSkinOffset(uint32(skin)), skinVertices);
+			}
+
+			//[t^[Qbg̍ _ƂɃ^[Qbg~(ʒu3, @3)
+			const uint32 targetCount = uint32(basePrimitive.targets.size());
+			const uint32 morphFloats = targetCount * 6;
+			std::vector<float32> morphData(vertices.size() * morphFloats, 0.0f);
+			for (uint32 target=0; target<targetCount; ++target)
+			{
+				const auto& ids = basePrimitive.targets[target];
+				const std::string* idDeltas[] = { &ids.positionsAccessorId, &ids.normalsAccessorId };
+				for (uint32 attr=0; attr<2; ++attr)
+				{
+					if (idDeltas[attr]->empty())
+					{
+						continue;
+					}
+					auto deltas = ReadNormalizedFloats(doc, *reader, doc.accessors.Get(*idDeltas[attr]));
+					size_t count = (std::min)(vertices.size(), deltas.size() / 3);
+					for (size_t idx=0; idx<count; ++idx)
+					{
+						float32* dst = &morphData[idx * morphFloats + target * 6 + attr * 3];
+						dst[0] = deltas[idx * 3 + 0];
+						dst[1] = deltas[idx * 3 + 1];
+						dst[2] = deltas[idx * 3 + 2];
+					}
+				}
+			}
+			meshTargets = (std::max)(meshTargets, targetCount);
+
+			//_Lv~eBũCfbNX܂Ƃ߂ēǂ
+			std::vector<const MeshPrimitive*> primitives;
+			std::vector<uint32> indices;
+			std::vector<size_t> indexStarts;
+			for (size_t idx=first; idx<mesh.primitives.size(); ++idx)
+			{
+				const auto& primitive = mesh.primitives[idx];
+				std::string primJoints, primWeights;
+				if (skinned)
+				{
+					primitive.TryGetAttributeAccessorId(ACCESSOR_JOINTS_0, primJoints);
+					primitive.TryGetAttributeAccessorId(ACCESSOR_WEIGHTS_0, primWeights);
+				}
+				if (loaded[idx] ||
+					primitive.GetAttributeAccessorId(ACCESSOR_POSITION) != idPos ||
+					primitive.GetAttributeAccessorId(ACCESSOR_NORMAL) != idNrm ||
+					primitive.GetAttributeAccessorId(ACCESSOR_TEXCOORD_0) != idUv ||
+					primJoints != idJoints || primWeights != idWeights ||
+					!sameTargets(primitive, basePrimitive))
+				{
+					continue;
+				}
+				loaded[idx] = true;
+				primitives.push_back(&primitive);
+				indexStarts.push_back(indices.size());
+				auto primIndices = reader->ReadBinaryData<uint32>(doc, doc.accessors.Get(primitive.indicesAccessorId));
+				indices.insert(indices.end(), primIndices.begin(), primIndices.end());
+			}
+			indexStarts.push_back(indices.size());
+
+			//d_nڂACfbNX
+			uint32 weldedCount = 0;
+			const uint32 vertexFloats = sizeof(Vertex) / sizeof(float32);
+			const uint32 skinFloats = skinned ? SkinPalette::MaxInfluences * 2 : 0;
+			if (skinFloats + morphFloats > 0)
+			{
+				//֐߁EEFCg⃂[t̍قȂ钸_܂Ƃ߂Ȃ悤ArɊ܂߂ėnڂ
+				const uint32 stride = vertexFloats + skinFloats + morphFloats;
+				std::vector<float32> weldData(vertices.size() * stride);
+				for (size_t idx=0; idx<vertices.size(); ++idx)
+				{
+					float32* dst = &weldData[idx * stride];
+					memcpy(dst, &vertices[idx], sizeof(Vertex));
+					for (uint32 k=0; k<skinFloats / 2; ++k)
+					{
+						dst[vertexFloats + k] = float32(skinVertices[idx].joints[k]);
+						dst[vertexFloats + SkinPalette::MaxInfluences + k] = skinVertices[idx].weights[k];
+					}
+					if (morphFloats > 0)
+					{
+						memcpy(dst + vertexFloats + skinFloats, &morphData[idx * morphFloats], sizeof(float32) * morphFloats);
+					}
+				}
+				weldedCount = VertexWelder::Weld(weldData.data(), stride * sizeof(float32), uint32(vertices.size()), indices.data(), indices.size(), weldEpsilon);
+				for (uint32 idx=0; idx<weldedCount; ++idx)
+				{
+					const float32* src = &weldData[idx * stride];
+					memcpy(&vertices[idx], src, sizeof(Vertex));
+					for (uint32 k=0; k<skinFloats / 2; ++k)
+					{
+						skinVertices[idx].joints[k] = uint16(src[vertexFloats + k]);
+						skinVertices[idx].weights[k] = src[vertexFloats + SkinPalette::MaxInfluences + k];
+					}
+					if (morphFloats > 0)
+					{
+						memcpy(&morphData[idx * morphFloats], src + vertexFloats + skinFloats, sizeof(float32) * morphFloats);
+					}
+				}
+			}
+			else
+			{
+				weldedCount = VertexWelder::Weld(vertices.data(), sizeof(Vertex), uint32(vertices.size()), indices.data(), indices.size(), weldEpsilon);
+			}
+			{
+				std::stringstream ss;
+				ss << "[ModelApp] weld '" << mesh.name << "' (" << primitives.size() << " primitives): "
+					<< vertices.size() << " -> " << weldedCount << " vertices ("
+					<< (vertices.empty() ? 0.0f : 100.0f * float32(vertices.size() - weldedCount) / float32(vertices.size())) << "% removed)" << std::endl;
+				OutputDebugStringA(ss.str().c_str());
+			}
+			vertices.resize(weldedCount);
+			skinVertices.resize(weldedCount);
+			morphData.resize(weldedCount * morphFloats);
+
+			uint32 vertexOffset = uint32(arenaVertices.size());
+			arenaVertices.insert(arenaVertices.end(), vertices.begin(), vertices.end());
+			arenaSkins.insert(arenaSkins.end(), skinVertices.begin(), skinVertices.end());
+			if (skinned)
+			{
+				model.skinnedRanges.push_back(SkinnedRange{ vertexOffset, weldedCount });
+				meshSkinned = true;
+			}
+			for (uint32 target=0; target<targetCount; ++target)
+			{
+				//Ȃ_MorphTargetsŎ̂Ă
+				std::vector<vec3> positions(weldedCount), normals(weldedCount);
+				for (uint32 idx=0; idx<weldedCount; ++idx)
+				{
+					const float32* src = &morphData[idx * morphFloats + target * 6];
+					positions[idx] = vec3(src[0], src[1], src[2]);
+					normals[idx] = vec3(src[3], src[4], src[5]);
+				}
+				model.morphs.AddTarget(morphBase + target, vertexOffset, weldedCount, positions.data(), normals.data());
+			}
+			for (size_t prim=0; prim<primitives.size(); ++prim)
+			{
+				std::vector<uint32> primIndices(indices.begin() + indexStarts[prim], indices.begin() + indexStarts[prim + 1]);
+				int32 materialIndex = int32(doc.materials.GetIndex(primitives[prim]->materialId));
+				//_PƂŎgv~eBuȂANZTmin/max̂܂܋EɂȂ
+				const Accessor* positionAccessor = (primitives.size() == 1) ? &accPos : nullptr;
+				_AppendModelMesh(model, vertices, vertexOffset, primIndices, materialIndex, positionAccessor, arenaIndices);
+			}
+		}
+
+		//m[hQƂĂȂbV͌_ɒu
+		//XLbV͊֐ߍs񂪃[h܂Ŋ܂ނ̂ŁAQƌ̃m[hł͂ȂPʍs̃m[hɒu
+		uint32 node = meshSkinned ? model.skinnedNode : meshNodes[meshIdx];
+		if (node == SceneGraph::InvalidNode)
+		{
+			node = model.scene.AddNode(SceneGraph::InvalidNode, vec3(0.0f), quat(1.0f, 0.0f, 0.0f, 0.0f), vec3(1.0f));
+		}
+		for (size_t idx=firstModelMesh; idx<model.meshes.size(); ++idx)
+		{
+			model.meshes[idx].node = node;
+			model.meshes[idx].skinned = meshSkinned;
+		}
+
+		//̃EFCg(Ȃ0)
+		model.morphWeights.resize(morphBase + meshTargets, 0.0f);
+		for (size_t idx=0; idx<mesh.weights.size(); ++idx)
+		{
+			model.morphWeights[morphBase + idx] = mesh.weights[idx];
+		}
+	}
+	model.morphs.Build(arenaVertices.data(), sizeof(Vertex));
+
+	//Rs[gXLjO̓͂ƈꎞ_obt@ւ̃Rs[ɂȂ
+	auto vbSize = uint32(sizeof(Vertex) * arenaVertices.size());
+	auto idSize = uint32(sizeof(uint32) * arenaIndices.size());
+	model.vertexCount = uint32(arenaVertices.size());
+	model.vertexBuffer = _CreateBufferObj(vbSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, arenaVertices.data());
+	auto skinSize = uint32(sizeof(SkinPalette::SkinVertex) * arenaSkins.size());
+	model.skinBuffer = _CreateBufferObj(skinSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, arenaSkins.data());
+	//[xvpXpɈʒu𓯂тŔo
+	{
+		std::vector<vec3> arenaPositions(arenaVertices.size());
+		for (size_t idx=0; idx<arenaVertices.size(); ++idx)
+		{
+			arenaPositions[idx] = arenaVertices[idx].pos;
+		}
+		auto posSize = uint32(sizeof(vec3) * arenaPositions.size());
+		model.positionBuffer = _CreateBufferObj(posSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, arenaPositions.data());
+	}
+	model.indexBuffer = _CreateBufferObj(idSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, arenaIndices.data());
+}
+
+void ModelApp::
+_CreateSceneGraph(Model& model, const Microsoft::glTF::Document& doc, std::vector<uint32>& nodeMap, std::vector<uint32>& meshNodes, std::vector<int32>& meshSkins)
+{
+	using namespace Microsoft::glTF;
+	const auto& nodes = doc.nodes.Elements();
+	const uint32 nodeCount = uint32(nodes.size());
+	meshNodes.assign(doc.meshes.Size(), SceneGraph::InvalidNode);
+	meshSkins.assign(doc.meshes.Size(), -1);
+
+	//qƂĎQƂȂm[hƂADɕׂ(eKɗ)
+	vector<uint32> parentOf(nodeCount, SceneGraph::InvalidNode);
+	for (uint32 idx=0; idx<nodeCount; ++idx)
+	{
+		for (const auto& childId : nodes[idx].children)
+		{
+			parentOf[doc.nodes.GetIndex(childId)] = idx;
+		}
+	}
+	vector<uint32> order;
+	order.reserve(nodeCount);
+	for (uint32 idx=0; idx<nodeCount; ++idx)
+	{
+		if (parentOf[idx] == SceneGraph::InvalidNode)
+		{
+			order.push_back(idx);
+		}
+	}
+	for (size_t head=0; head<order.size(); ++head)
+	{
+		for (const auto& childId : nodes[order[head]].children)
+		{
+			order.push_back(uint32(doc.nodes.GetIndex(childId)));
+		}
+	}
+
+	nodeMap.assign(nodeCount, SceneGraph::InvalidNode);
+	for (auto gltfIdx : order)
+	{
+		const auto& node = nodes[gltfIdx];
+		vec3 translation(0.0f);
+		quat rotation(1.0f, 0.0f, 0.0f, 0.0f);
+		vec3 scale(1.0f);
+		if (node.GetTransformationType() == TRANSFORMATION_MATRIX)
+		{
+			//sŗ^ꂽm[hTRS֕(f͈Ȃ)
+			const auto& v = node.matrix.values;
+			vec3 axes[3] = { vec3(v[0], v[1], v[2]), vec3(v[4], v[5], v[6]), vec3(v[8], v[9], v[10]) };
+			translation = vec3(v[12], v[13], v[14]);
+			scale = vec3(length(axes[0]), length(axes[1]), length(axes[2]));
+			rotation = quat_cast(mat3(axes[0] / scale.x, axes[1] / scale.y, axes[2] / scale.z));
+		}
+		else
+		{
+			translation = vec3(node.translation.x, node.translation.y, node.translation.z);
+			rotation = quat(node.rotation.w, node.rotation.x, node.rotation.y, node.rotation.z);
+			scale = vec3(node.scale.x, node.scale.y, node.scale.z);
+		}
+		uint32 parent = (parentOf[gltfIdx] != SceneGraph::InvalidNode) ? nodeMap[parentOf[gltfIdx]] : SceneGraph::InvalidNode;
+		nodeMap[gltfIdx] = model.scene.AddNode(parent, translation, rotation, scale);
+
+		//̃m[hQƂ郁bV͍ŏ̃m[hɒu
+		if (!node.meshId.empty())
+		{
+			auto meshIdx = doc.meshes.GetIndex(node.meshId);
+			if (meshNodes[meshIdx] == SceneGraph::InvalidNode)
+			{
+				meshNodes[meshIdx] = nodeMap[gltfIdx];
+				meshSkins[meshIdx] = node.skinId.empty() ? -1 : int32(doc.skins.GetIndex(node.skinId));
+			}
+		}
+	}
+}
+
+void ModelApp::
+_CreateSkins(Model& model, const Microsoft::glTF::Document& doc, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader, const std::vector<uint32>& nodeMap)
+{
+	model.skinnedNode = SceneGraph::InvalidNode;
+	for (const auto& skin : doc.skins.Elements())
+	{
+		vector<uint32> jointNodes;
+		for (const auto& jointId : skin.jointIds)
+		{
+			jointNodes.push_back(nodeMap[doc.nodes.GetIndex(jointId)]);
+		}
+		//toChs񂪖ΒPʍsƂ݂Ȃ
+		vector<mat4> inverseBinds;
+		if (!skin.inverseBindMatricesAccessorId.empty())
+		{
+			auto data = reader->ReadBinaryData<float32>(doc, doc.accessors.Get(skin.inverseBindMatricesAccessorId));
+			inverseBinds.resize(data.size() / 16);
+			memcpy(inverseBinds.data(), data.data(), sizeof(mat4) * inverseBinds.size());
+		}
+		model.skins.AddSkin(jointNodes, inverseBinds);
+	}
+	if (model.skins.GetSkinCount() > 0)
+	{
+		model.skinnedNode = model.scene.AddNode(SceneGraph::InvalidNode, vec3(0.0f), quat(1.0f, 0.0f, 0.0f, 0.0f), vec3(1.0f));
+	}
+}
+
+void ModelApp::
+_CreateAnimations(Model& model, const Microsoft::glTF::Document& doc, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader, const std::vector<uint32>& nodeMap)
+{
+	using namespace Microsoft::glTF;
+	model.clips.clear();
+	model.animationNodes = nodeMap;
+	for (const auto& animation : doc.animations.Elements())
+	{
+		AnimationClip clip;
+		for (const auto& channel : animation.channels.Elements())
+		{
+			//[t̃EFCg͑ΏۊO
+			AnimationClip::Path path;
+			switch (channel.target.path)
+			{
+			case TARGET_TRANSLATION:	path = AnimationClip::PathTranslation; break;
+			case TARGET_ROTATION:		path = AnimationClip::PathRotation; break;
+			case TARGET_SCALE:			path = AnimationClip::PathScale; break;
+			default:					continue;
+			}
+			const auto& sampler = animation.samplers.Get(channel.samplerId);
+			AnimationClip::Interpolation interpolation;
+			switch (sampler.interpolation)
+			{
+			case INTERPOLATION_STEP:		interpolation = AnimationClip::InterpolationStep; break;
+			case INTERPOLATION_CUBICSPLINE:	interpolation = AnimationClip::InterpolationCubicSpline; break;
+			default:						interpolation = AnimationClip::InterpolationLinear; break;
+			}
+
+			auto times = reader->ReadBinaryData<float32>(doc, doc.accessors.Get(sampler.inputAccessorId));
+			auto values = ReadNormalizedFloats(doc, *reader, doc.accessors.Get(sampler.outputAccessorId));
+			size_t components = (path == AnimationClip::PathRotation) ? 4 : 3;
+			size_t valuesPerKey = (interpolation == AnimationClip::InterpolationCubicSpline) ? 3 : 1;
+			uint32 keyCount = uint32((std::min)(times.size(), values.size() / (components * valuesPerKey)));
+			clip.AddTrack(uint32(doc.nodes.GetIndex(channel.target.nodeId)), path, interpolation, times.data(), keyCount, values.data());
+		}
+		if (clip.GetTrackCount() == 0)
+		{
+			continue;
+		}
+
+		//ʎqĎAk񂾑傫Ɗ֐߂Ƃ̍ő덷o
+		CompressedClip compressed;
+		compressed.Compress(clip);
+		std::vector<CompressedClip::Error> errors;
+		compressed.MeasureError(clip, uint32(doc.nodes.Size()), errors);
+		std::stringstream ss;
+		ss << "[ModelApp] animation '" << animation.name << "': " << compressed.GetTrackCount() << " tracks ("
+			<< compressed.GetConstantTrackCount() << " constant) " << clip.GetByteSize() << " -> " << compressed.GetByteSize() << " bytes ("
+			<< (float32(clip.GetByteSize()) / float32((std::max)(compressed.GetByteSize(), 1u))) << "x)\n";
+		std::vector<bool> animated(errors.size(), false);
+		for (uint32 trackIdx=0; trackIdx<clip.GetTrackCount(); ++trackIdx)
+		{
+			animated[clip.GetTrack(trackIdx).target] = true;
+		}
+		for (uint32 target=0; target<uint32(errors.size()); ++target)
+		{
+			if (animated[target])
+			{
+				const auto& error = errors[target];
+				ss << "  '" << doc.nodes.Elements()[target].name << "' max error t=" << error.translation
+					<< " r=" << glm::degrees(error.rotation) << "deg s=" << error.scale << "\n";
+			}
+		}
+		OutputDebugStringA(ss.str().c_str());
+		model.clips.push_back(compressed);
+	}
+}
+
+void ModelApp::
+_UpdateAnimation(void)
+{
+	const float32 FadeSeconds = 0.3f;
+	if (m_model.clips.empty())
+	{
+		return;
+	}
+	float64 now = glfwGetTime();
+	float32 dt = (m_animationLastTime >= 0.0) ? float32(now - m_animationLastTime) : 0.0f;
+	m_animationLastTime = now;
+
+	//NL[Ŏ̃NbvփNXtF[h
+	bool keyDown = glfwGetKey(m_window, GLFW_KEY_N) == GLFW_PRESS;
+	if (keyDown && !m_animationKeyDown && m_model.clips.size() > 1)
+	{
+		m_animationFadeFrom = m_animationClip;
+		m_animationClip = (m_animationClip + 1) % uint32(m_model.clips.size());
+		m_animationTimes[m_animationClip] = 0.0f;
+		m_animationFade = 0.0f;
+		std::stringstream ss;
+		ss << "[ModelApp] animation clip " << m_animationClip << "\n";
+		OutputDebugStringA(ss.str().c_str());
+	}
+	m_animationKeyDown = keyDown;
+
+	if (m_animationFadeFrom != ~0u)
+	{
+		m_animationFade += dt / FadeSeconds;
+		if (m_animationFade >= 1.0f)
+		{
+			m_animationFadeFrom = ~0u;
+		}
+	}
+
+	//Đ̃Nbvi߂ăEFCgtŏd˂(߂gbN̓J[\T)
+	m_animationPose.Reset(uint32(m_model.animationNodes.size()));
+	uint32 clips[] = { m_animationClip, m_animationFadeFrom };
+	float32 weights[] = { (m_animationFadeFrom != ~0u) ? m_animationFade : 1.0f, 1.0f - m_animationFade };
+	for (uint32 idx=0; idx<2; ++idx)
+	{
+		uint32 clip = clips[idx];
+		if (clip == ~0u)
+		{
+			continue;
+		}
+		const auto& data = m_model.clips[clip];
+		float32& time = m_animationTimes[clip];
+		time += dt;
+		if (data.GetDuration() > 0.0f)
+		{
+			time = fmodf(time, data.GetDuration());
+		}
+		data.Sample(time, m_animationCursors[clip].data(), weights[idx], m_animationPose);
+	}
+	m_animationPose.Apply(m_model.animationNodes.data(), m_model.scene);
+}
+
+void ModelApp::
+_ReadSkinVertices(const Microsoft::glTF::Document& doc, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader, const Microsoft::glTF::MeshPrimitive& primitive, uint32 jointOffset, std::vector<SkinPalette::SkinVertex>& skinVertices)
+{
+	using namespace Microsoft::glTF;
+	const uint32 influences = SkinPalette::MaxInfluences;
+	auto& accJoints = doc.accessors.Get(primitive.GetAttributeAccessorId(ACCESSOR_JOINTS_0));
+	auto& accWeights = doc.accessors.Get(primitive.GetAttributeAccessorId(ACCESSOR_WEIGHTS_0));
+
+	//֐ߔԍUNSIGNED_BYTEUNSIGNED_SHORT
+	vector<uint32> joints;
+	if (accJoints.componentType == COMPONENT_UNSIGNED_BYTE)
+	{
+		auto data = reader->ReadBinaryData<uint8>(doc, accJoints);
+		joints.assign(data.begin(), data.end());
+	}
+	else
+	{
+		auto data = reader->ReadBinaryData<uint16>(doc, accJoints);
+		joints.assign(data.begin(), data.end());
+	}
+	//EFCgFLOATKꂽ
+	auto weights = ReadNormalizedFloats(doc, *reader, accWeights);
+
+	const size_t count = (std::min)(skinVertices.size(), (std::min)(joints.size(), weights.size()) / influences);
+	for (size_t v=0; v<count; ++v)
+	{
+		auto& sv = skinVertices[v];
+		float32 sum = 0.0f;
+		for (uint32 k=0; k<influences; ++k)
+		{
+			sv.joints[k] = uint16((std::min)(jointOffset + joints[v * influences + k], SkinPalette::MaxJoints - 1));
+			sv.weights[k] = weights[v * influences + k];
+			sum += sv.weights[k];
+		}
+		//ʎqōvꂽEFCg1֖߂
+		if (sum > 0.0f)
+		{
+			for (uint32 k=0; k<influences; ++k)
+			{
+				sv.weights[k] /= sum;
+			}
+		}
+	}
+}
+
+void ModelApp::
+_UpdateWorldBounds(Model& model, bool all)
+{
+	const auto& scene = model.scene;
+	const auto& local = model.localBounds;
+	++model.boundsVersion;
+	for (uint32 meshIdx=0; meshIdx<uint32(model.meshes.size()); ++meshIdx)
+	{
+		uint32 node = model.meshes[meshIdx].node;
+		if (!all && !scene.IsWorldChanged(node))
+		{
+			continue;
+		}
+		//AABB͊e̐ΒlōLAa͍ő̎{ōL
+		const auto& world = scene.GetWorld(node);
+		vec3 center = vec3(world * vec4(local.GetCenter(meshIdx), 1.0f));
+		vec3 half = (local.GetMax(meshIdx) - local.GetMin(meshIdx)) * 0.5f;
+		mat3 basis(world);
+		vec3 extent = abs(basis[0]) * half.x + abs(basis[1]) * half.y + abs(basis[2]) * half.z;
+		float32 scale = sqrtf((std::max)((std::max)(dot(basis[0], basis[0]), dot(basis[1], basis[1])), dot(basis[2], basis[2])));
+		float32 radius = local.GetRadius(meshIdx) * scale;
+		model.bounds.Set(meshIdx, center - extent, center + extent, center, radius);
+
+		//GPUJO̓͂̍s(et[̃obt@ւ_DispatchGpuCullingŎʂ)
+		if (meshIdx < uint32(model.cullInstances.size()))
+		{
+			auto& inst = model.cullInstances[meshIdx];
+			inst.sphere = vec4(center, radius);
+			inst.aabbMin = vec4(center - extent, 0.0f);
+			inst.aabbMax = vec4(center + extent, 0.0f);
+			model.cullInstanceVersions[meshIdx] = model.boundsVersion;
+		}
+	}
+}
+
+void ModelApp::
+_AppendModelMesh(Model& model, const std::vector<Vertex>& vertices, uint32 vertexOffset, std::vector<uint32>& indices, int32 materialIndex, const Microsoft::glTF::Accessor* positionAccessor, std::vector<uint32>& arenaIndices)
+{
+	const float32 lodMaxError = 0.05f;
+
+	//bVbg֕ACfbNXbVbgɕבւ
+	ModelMesh mesh{};
+	MeshletBuilder::Build(&vertices[0].pos.x, sizeof(Vertex), uint32(vertices.size()), indices, mesh.meshlets);
+
+	//LOD0iKIɔȗCfbNX
+	vector<vector<uint32>> lodIndices;
+	vector<float32> lodErrors;
+	lodIndices.push_back(indices);
+	lodErrors.push_back(0.0f);
+	while (lodIndices.size() < LodSelector::MaxLods)
+	{
+		const auto& prev = lodIndices.back();
+		vector<uint32> simplified;
+		auto error = MeshSimplifier::Simplify(&vertices[0].pos.x, sizeof(Vertex), uint32(vertices.size()), prev, uint32(prev.size() / 6) * 3, lodMaxError, simplified);
+		//قƂǌȂ΂ȏLOD͍Ȃ
+		if (simplified.empty() || simplified.size() * 10 > prev.size() * 9)
+		{
+			break;
+		}
+		lodIndices.push_back(std::move(simplified));
+		lodErrors.push_back((std::max)(error, lodErrors.back()));
+	}
+
+	//Lobt@֋l߂
+	uint32 baseIndex = uint32(arenaIndices.size());
+	for (auto& meshlet : mesh.meshlets)
+	{
+		meshlet.firstIndex += baseIndex;
+	}
+	for (size_t lod=0; lod<lodIndices.size(); ++lod)
+	{
+		mesh.lods.push_back(MeshLod{ uint32(arenaIndices.size()), uint32(lodIndices[lod].size()), lodErrors[lod] });
+		arenaIndices.insert(arenaIndices.end(), lodIndices[lod].begin(), lodIndices[lod].end());
+	}
+	mesh.vertexOffset = vertexOffset;
+	mesh.vertexCount = uint32(vertices.size());
+
+	//E(̃v~eBuQƂ钸_̂)
+	//ANZTmin/max΂gAΈʒuSIMDő
+	vec3 aabbMin, aabbMax;
+	float32 radius;
+	if (positionAccessor != nullptr && positionAccessor->min.size() >= 3 && positionAccessor->max.size() >= 3)
+	{
+		aabbMin = vec3(positionAccessor->min[0], positionAccessor->min[1], positionAccessor->min[2]);
+		aabbMax = vec3(positionAccessor->max[0], positionAccessor->max[1], positionAccessor->max[2]);
+		radius = glm::length(aabbMax - aabbMin) * 0.5f;
+	}
+	else
+	{
+		BoundsTable::ComputeAabb(&vertices[0].pos.x, sizeof(Vertex), indices.data(), indices.size(), aabbMin, aabbMax);
+		radius = BoundsTable::ComputeRadius(&vertices[0].pos.x, sizeof(Vertex), indices.data(), indices.size(), (aabbMin + aabbMax) * 0.5f);
+	}
+	model.localBounds.Add(aabbMin, aabbMax, (aabbMin + aabbMax) * 0.5f, radius);
+	model.bounds.Add(aabbMin, aabbMax, (aabbMin + aabbMax) * 0.5f, radius);
+
+	mesh.materialIndex = materialIndex;
+	model.meshes.push_back(mesh);
+}
+
+void ModelApp::
+_CreateModelMaterial(Model& model, const Microsoft::glTF::Document& doc, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader, std::vector<std::vector<char>>& images)
+{
+	for (auto& m : doc.materials.Elements())
+	{
+		auto textureId = m.metallicRoughness.baseColorTexture.textureId;
+		if (textureId.empty())
+		{
+			textureId = m.normalTexture.textureId;
+		}
+		auto& texture = doc.textures.Get(textureId);
+		auto& image = doc.images.Get(texture.imageId);
+		auto imageBufferView = doc.bufferViews.Get(image.bufferViewId);
+		images.push_back(reader->ReadBinaryData<char>(doc, imageBufferView));
+
+		//eNX`̓fR[h̃Wuō
+		Material material{};
+		material.alphaMode = m.alphaMode;
+		material.doubleSided = m.doubleSided;
+		model.materials.push_back(material);
+	}
+}
+
+void ModelApp::
+_CreateComputePipelines(void)
+{
+	const VkMemoryPropertyFlags hostFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	const uint32 frameCount = uint32(m_swapchainViews.size());
+	m_vkCmdDrawIndexedIndirectCountKHR = reinterpret_cast<PFN_vkCmdDrawIndexedIndirectCountKHR>(vkGetDeviceProcAddr(m_vkDevice, "vkCmdDrawIndexedIndirectCountKHR"));
+
+	//GPUJO
+	{
+		array<VkDescriptorSetLayoutBinding, 6> bindings{};
+		for (uint32 idx=0; idx<uint32(bindings.size()); ++idx)
+		{
+			bindings[idx].binding = idx;
+			bindings[idx].descriptorType = CullDescriptorTypes[idx];
+			bindings[idx].descriptorCount = 1;
+			bindings[idx].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+		m_cullDescriptorSetLayout = m_descriptors.GetLayout(bindings.data(), uint32(bindings.size()));
+
+		VkPipelineLayoutCreateInfo pipelineLayoutCi{};
+		pipelineLayoutCi.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutCi.setLayoutCount = 1;
+		pipelineLayoutCi.pSetLayouts = &m_cullDescriptorSetLayout;
+		vkCreatePipelineLayout(m_vkDevice, &pipelineLayoutCi, nullptr, &m_cullPipelineLayout);
+
+		VkComputePipelineCreateInfo ci{};
+		ci.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		ci.stage = _LoadShaderModule(L"shader\\cull.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+		ci.layout = m_cullPipelineLayout;
+		vkCreateComputePipelines(m_vkDevice, VK_NULL_HANDLE, 1, &ci, nullptr, &m_cullPipeline);
+		vkDestroyShaderModule(m_vkDevice, ci.stage.module, nullptr);
+
+		//p[^̓f̑傫ɂȂ
+		m_cullParamBuffers.resize(frameCount);
+		for (auto& v : m_cullParamBuffers)
+		{
+			v = _CreateBufferObj(sizeof(CullParameters), VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, hostFlags, nullptr);
+		}
+	}
+
+	//[t(̒_, , , EFCg, o͒_, o͈ʒu)
+	{
+		array<VkDescriptorSetLayoutBinding, 6> bindings{};
+		for (uint32 idx=0; idx<uint32(bindings.size()); ++idx)
+		{
+			bindings[idx].binding = idx;
+			bindings[idx].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[idx].descriptorCount = 1;
+			bindings[idx].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+		m_morphDescriptorSetLayout = m_descriptors.GetLayout(bindings.data(), uint32(bindings.size()));
+
+		//_̐̓vbV萔œn
+		VkPushConstantRange pushRange{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(uint32) };
+		VkPipelineLayoutCreateInfo pipelineLayoutCi{};
+		pipelineLayoutCi.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutCi.setLayoutCount = 1;
+		pipelineLayoutCi.pSetLayouts = &m_morphDescriptorSetLayout;
+		pipelineLayoutCi.pushConstantRangeCount = 1;
+		pipelineLayoutCi.pPushConstantRanges = &pushRange;
+		vkCreatePipelineLayout(m_vkDevice, &pipelineLayoutCi, nullptr, &m_morphPipelineLayout);
+
+		VkComputePipelineCreateInfo ci{};
+		ci.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		ci.stage = _LoadShaderModule(L"shader\\morph.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+		ci.layout = m_morphPipelineLayout;
+		vkCreateComputePipelines(m_vkDevice, VK_NULL_HANDLE, 1, &ci, nullptr, &m_morphPipeline);
+		vkDestroyShaderModule(m_vkDevice, ci.stage.module, nullptr);
+	}
+
+	//XLjO(̒_, ֐߁EEFCg, ֐ߍs, o͒_, o͈ʒu)
+	{
+		array<VkDescriptorSetLayoutBinding, 5> bindings{};
+		for (uint32 idx=0; idx<uint32(bindings.size()); ++idx)
+		{
+			bindings[idx].binding = idx;
+			bindings[idx].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			bindings[idx].descriptorCount = 1;
+			bindings[idx].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		}
+		m_skinDescriptorSetLayout = m_descriptors.GetLayout(bindings.data(), uint32(bindings.size()));
+
+		//͈͂̓vbV萔œn
+		VkPushConstantRange pushRange{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SkinnedRange) };
+		VkPipelineLayoutCreateInfo pipelineLayoutCi{};
+		pipelineLayoutCi.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		pipelineLayoutCi.setLayoutCount = 1;
+		pipelineLayoutCi.pSetLayouts = &m_skinDescriptorSetLayout;
+		pipelineLayoutCi.pushConstantRangeCount = 1;
+		pipelineLayoutCi.pPushConstantRanges = &pushRange;
+		vkCreatePipelineLayout(m_vkDevice, &pipelineLayoutCi, nullptr, &m_skinPipelineLayout);
+
+		VkComputePipelineCreateInfo ci{};
+		ci.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		ci.stage = _LoadShaderModule(L"shader\\skin.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+		ci.layout = m_skinPipelineLayout;
+		vkCreateComputePipelines(m_vkDevice, VK_NULL_HANDLE, 1, &ci, nullptr, &m_skinPipeline);
+		vkDestroyShaderModule(m_vkDevice, ci.stage.module, nullptr);
+
+		//Rs[g̎Ԃ̓fBXpb`̑OŌv
+		if (m_timestampPool != VK_NULL_HANDLE)
+		{
+			VkQueryPoolCreateInfo queryCi{};
+			queryCi.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+			queryCi.queryType = VK_QUERY_TYPE_TIMESTAMP;
+			queryCi.queryCount = frameCount * 2;
+			vkCreateQueryPool(m_vkDevice, &queryCi, nullptr, &m_skinQueryPool);
+			m_skinQueryWritten.assign(frameCount, false);
+		}
+	}
+}
+
+void ModelApp::
+_DestroyComputePipelines(void)
+{
+	//Zbg̃CAEgm_descriptorsj
+	if (m_skinQueryPool != VK_NULL_HANDLE)
+	{
+		vkDestroyQueryPool(m_vkDevice, m_skinQueryPool, nullptr);
+	}
+	vkDestroyPipeline(m_vkDevice, m_skinPipeline, nullptr);
+	vkDestroyPipelineLayout(m_vkDevice, m_skinPipelineLayout, nullptr);
+	vkDestroyPipeline(m_vkDevice, m_morphPipeline, nullptr);
+	vkDestroyPipelineLayout(m_vkDevice, m_morphPipelineLayout, nullptr);
+	vkDestroyPipeline(m_vkDevice, m_cullPipeline, nullptr);
+	vkDestroyPipelineLayout(m_vkDevice, m_cullPipelineLayout, nullptr);
+	for (auto& v : m_cullParamBuffers)
+	{
+		vkDestroyBuffer(m_vkDevice, v.buffer, nullptr);
+		vkFreeMemory(m_vkDevice, v.memory, nullptr);
+	}
+	m_cullParamBuffers.clear();
+	m_skinQueryPool = VK_NULL_HANDLE;
+	m_skinQueryWritten.clear();
+	m_skinPipeline = VK_NULL_HANDLE;
+	m_skinPipelineLayout = VK_NULL_HANDLE;
+	m_morphPipeline = VK_NULL_HANDLE;
+	m_morphPipelineLayout = VK_NULL_HANDLE;
+	m_cullPipeline = VK_NULL_HANDLE;
+	m_cullPipelineLayout = VK_NULL_HANDLE;
+}
+
+void ModelApp::
+_CreateGpuCullingBuffers(Model& model)
+{
+	using namespace Microsoft::glTF;
+	const uint32 meshCount = uint32(model.meshes.size());
+	if (meshCount == 0)
+	{
+		return;
+	}
+
+	//At@[h̕`揇A}eAAm[h̏ɃbVׂăoPbgɕ
+	vector<uint32> order(meshCount);
+	for (uint32 idx=0; idx<meshCount; ++idx)
+	{
+		order[idx] = idx;
+	}
+	std::stable_sort(order.begin(), order.end(), [&](uint32 l, uint32 r)
+	{
+		const auto& ml = model.meshes[l];
+		const auto& mr = model.meshes[r];
+		uint32 orderL = _GetRenderPass(model.materials[ml.materialIndex].alphaMode);
+		uint32 orderR = _GetRenderPass(model.materials[mr.materialIndex].alphaMode);
+		if (orderL != orderR)
+		{
+			return orderL < orderR;
+		}
+		return (ml.materialIndex != mr.materialIndex) ? (ml.materialIndex < mr.materialIndex) : (ml.node < mr.node);
+	});
+
+	auto& instances = model.cullInstances;
+	instances.resize(meshCount);
+	model.cullInstanceVersions.assign(meshCount, model.boundsVersion);
+	int32 bucketMaterial = -1;
+	uint32 bucketNode = SceneGraph::InvalidNode;
+	for (uint32 slot=0; slot<meshCount; ++slot)
+	{
+		uint32 meshIdx = order[slot];
+		const auto& mesh = model.meshes[meshIdx];
+		if (mesh.materialIndex != bucketMaterial || mesh.node != bucketNode)
+		{
+			model.drawBuckets.push_back(DrawBucket{ model.materials[mesh.materialIndex].alphaMode, meshIdx, slot, 0 });
+			bucketMaterial = mesh.materialIndex;
+			bucketNode = mesh.node;
+		}
+		auto& bucket = model.drawBuckets.back();
+		++bucket.capacity;
+
+		auto& inst = instances[meshIdx];
+		inst.sphere = vec4(model.bounds.GetCenter(meshIdx), model.bounds.GetRadius(meshIdx));
+		inst.aabbMin = vec4(model.bounds.GetMin(meshIdx), 0.0f);
+		inst.aabbMax = vec4(model.bounds.GetMax(meshIdx), 0.0f);
+		for (uint32 lod=0; lod<LodSelector::MaxLods; ++lod)
+		{
+			//LOD͍łeLODŖ߂Ă
+			const auto& range = mesh.lods[(std::min)(lod, uint32(mesh.lods.size()) - 1)];
+			inst.lodFirstIndex[lod] = range.firstIndex;
+			inst.lodIndexCount[lod] = range.indexCount;
+		}
+		inst.info[0] = uint32(mesh.lods.size());
+		inst.info[1] = mesh.vertexOffset;
+		inst.info[2] = uint32(model.drawBuckets.size() - 1);
+		inst.info[3] = slot;
+		inst.draw[0] = bucket.drawBase;
+	}
+
+	//͂Əo͂̃obt@
+	const VkMemoryPropertyFlags hostFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	vector<uint32> lodStates(meshCount, 0);
+	model.cullLodStateBuffer = _CreateBufferObj(uint32(sizeof(uint32) * meshCount), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostFlags, lodStates.data());
+	const uint32 frameCount = uint32(m_swapchainViews.size());
+	model.cullInstanceBuffers.resize(frameCount);
+	model.indirectBuffers.resize(frameCount);
+	model.drawCountBuffers.resize(frameCount);
+	for (uint32 idx=0; idx<frameCount; ++idx)
+	{
+		model.cullInstanceBuffers[idx] = _CreateBufferObj(uint32(sizeof(GpuInstance) * meshCount), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostFlags, instances.data());
+		model.indirectBuffers[idx] = _CreateBufferObj(uint32(sizeof(VkDrawIndexedIndirectCommand) * meshCount), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, nullptr);
+		model.drawCountBuffers[idx] = _CreateBufferObj(uint32(sizeof(uint32) * model.drawBuckets.size()), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, nullptr);
+	}
+}
+
+void ModelApp::
+_CreateGpuCulling(void)
+{
+	//obt@͓ǂݍ݂̃[J[ōĂ̂ŁAt[Ƃ̃Zbg
+	if (m_model.drawBuckets.empty() || m_cullPipeline == VK_NULL_HANDLE)
+	{
+		return;
+	}
+	const uint32 frameCount = uint32(m_swapchainViews.size());
+	m_cullDescriptorSets.resize(frameCount);
+	for (uint32 idx=0; idx<frameCount; ++idx)
+	{
+		m_cullDescriptorSets[idx] = m_descriptors.Allocate(m_cullDescriptorSetLayout);
+		VkDescriptorBufferInfo infos[] = {
+			{ m_model.cullInstanceBuffers[idx].buffer, 0, VK_WHOLE_SIZE },
+			{ m_model.indirectBuffers[idx].buffer, 0, VK_WHOLE_SIZE },
+			{ m_model.drawCountBuffers[idx].buffer, 0, VK_WHOLE_SIZE },
+			{ m_model.cullLodStateBuffer.buffer, 0, VK_WHOLE_SIZE },
+			{ m_cullParamBuffers[idx].buffer, 0, VK_WHOLE_SIZE },
+		};
+		VkDescriptorImageInfo hizInfo{ m_hizSampler, m_depthPyramid.view, VK_IMAGE_LAYOUT_GENERAL };
+		array<VkWriteDescriptorSet, 6> writes{};
+		for (uint32 binding=0; binding<uint32(writes.size()); ++binding)
+		{
+			writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[binding].dstSet = m_cullDescriptorSets[idx];
+			writes[binding].dstBinding = binding;
+			writes[binding].descriptorCount = 1;
+			writes[binding].descriptorType = CullDescriptorTypes[binding];
+			if (CullDescriptorTypes[binding] == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER)
+			{
+				writes[binding].pImageInfo = &hizInfo;
+			}
+			else
+			{
+				writes[binding].pBufferInfo = &infos[binding];
+			}
+		}
+		vkUpdateDescriptorSets(m_vkDevice, uint32(writes.size()), writes.data(), 0, nullptr);
+	}
+	m_cullUploadVersions.assign(frameCount, m_model.boundsVersion);
+	m_gpuCulling = (m_cullPipeline != VK_NULL_HANDLE);
+}
+
+void ModelApp::
+_DestroyGpuCulling(void)
+{
+	//obt@_DestroyModelŊJ
+	_RetireDescriptorSets(m_cullDescriptorSetLayout, m_cullDescriptorSets);
+	m_cullDescriptorSets.clear();
+	m_cullUploadVersions.clear();
+	m_gpuCulling = false;
+}
+
+void ModelApp::
+_CreateMorphingBuffers(Model& model)
+{
+	const auto& morphs = model.morphs;
+	if (morphs.Size() == 0)
+	{
+		return;
+	}
+
+	//`ƃRs[gXLjO̓͂ɂȂ钸_͌̒_ŏĂA_
+	const VkMemoryPropertyFlags hostFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	const VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+	const uint32 frameCount = uint32(m_swapchainViews.size());
+	const uint32 vbSize = uint32(sizeof(Vertex) * model.vertexCount);
+	const uint32 posSize = uint32(sizeof(float32) * 3 * model.vertexCount);
+	void* baseVertices;
+	void* basePositions;
+	vkMapMemory(m_vkDevice, model.vertexBuffer.memory, 0, VK_WHOLE_SIZE, 0, &baseVertices);
+	vkMapMemory(m_vkDevice, model.positionBuffer.memory, 0, VK_WHOLE_SIZE, 0, &basePositions);
+	model.morphVertexBuffers.resize(frameCount);
+	model.morphPositionBuffers.resize(frameCount);
+	for (uint32 idx=0; idx<frameCount; ++idx)
+	{
+		model.morphVertexBuffers[idx] = _CreateBufferObj(vbSize, usage, hostFlags, baseVertices);
+		model.morphPositionBuffers[idx] = _CreateBufferObj(posSize, usage, hostFlags, basePositions);
+	}
+	vkUnmapMemory(m_vkDevice, model.vertexBuffer.memory);
+	vkUnmapMemory(m_vkDevice, model.positionBuffer.memory);
+
+	//wɃEFCgԍăVF[_[֓n
+	vector<MorphTargets::Delta> deltas(morphs.GetDeltas());
+	for (uint32 idx=0; idx<uint32(deltas.size()); ++idx)
+	{
+		uint32 weight = morphs.GetDeltaWeights()[idx];
+		memcpy(&deltas[idx].position.w, &weight, sizeof(weight));
+	}
+	model.morphRangeBuffer = _CreateBufferObj(uint32(sizeof(MorphTargets::Range) * morphs.GetRanges().size()), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostFlags, morphs.GetRanges().data());
+	model.morphDeltaBuffer = _CreateBufferObj(uint32(sizeof(MorphTargets::Delta) * deltas.size()), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostFlags, deltas.data());
+	model.morphWeightBuffers.resize(frameCount);
+	for (auto& v : model.morphWeightBuffers)
+	{
+		v = _CreateBufferObj(uint32(sizeof(float32) * (std::max)(morphs.GetWeightCount(), 1u)), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostFlags, nullptr);
+	}
+}
+
+void ModelApp::
+_CreateMorphing(void)
+{
+	const auto& morphs = m_model.morphs;
+	m_morphWeights = m_model.morphWeights;
+	if (morphs.Size() == 0)
+	{
+		return;
+	}
+	const uint32 frameCount = uint32(m_swapchainViews.size());
+	m_morphDirty.assign(frameCount, false);
+	m_morphPositions.resize(morphs.Size());
+	m_morphNormals.resize(morphs.Size());
+
+	m_morphDescriptorSets.resize(frameCount);
+	for (uint32 idx=0; idx<frameCount; ++idx)
+	{
+		m_morphDescriptorSets[idx] = m_descriptors.Allocate(m_morphDescriptorSetLayout);
+		VkDescriptorBufferInfo infos[] = {
+			{ m_model.vertexBuffer.buffer, 0, VK_WHOLE_SIZE },
+			{ m_model.morphRangeBuffer.buffer, 0, VK_WHOLE_SIZE },
+			{ m_model.morphDeltaBuffer.buffer, 0, VK_WHOLE_SIZE },
+			{ m_model.morphWeightBuffers[idx].buffer, 0, VK_WHOLE_SIZE },
+			{ m_model.morphVertexBuffers[idx].buffer, 0, VK_WHOLE_SIZE },
+			{ m_model.morphPositionBuffers[idx].buffer, 0, VK_WHOLE_SIZE },
+		};
+		array<VkWriteDescriptorSet, 6> writes{};
+		for (uint32 binding=0; binding<uint32(writes.size()); ++binding)
+		{
+			writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[binding].dstSet = m_morphDescriptorSets[idx];
+			writes[binding].dstBinding = binding;
+			writes[binding].descriptorCount = 1;
+			writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[binding].pBufferInfo = &infos[binding];
+		}
+		vkUpdateDescriptorSets(m_vkDevice, uint32(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	std::stringstream ss;
+	ss << "[ModelApp] morph " << morphs.GetWeightCount() << " targets, " << morphs.Size() << "/" << m_model.vertexCount << " vertices, "
+		<< morphs.GetDeltaCount() << " deltas (" << (m_morphPipeline != VK_NULL_HANDLE ? "compute" : "cpu") << ")\n";
+	OutputDebugStringA(ss.str().c_str());
+}
+
+void ModelApp::
+_DestroyMorphing(void)
+{
+	_RetireDescriptorSets(m_morphDescriptorSetLayout, m_morphDescriptorSets);
+	m_morphDescriptorSets.clear();
+	m_morphDirty.clear();
+}
+
+void ModelApp::
+_DispatchMorphing(VkCommandBuffer command)
+{
+	const auto& morphs = m_model.morphs;
+	if (morphs.Size() == 0)
+	{
+		return;
+	}
+
+	//fł̓^[Qbg1b010Ɠ
+	const uint32 weightCount = morphs.GetWeightCount();
+	m_morphWeights = m_model.morphWeights;
+	if (m_morphDemo && weightCount > 0)
+	{
+		float64 t = glfwGetTime();
+		uint32 target = uint32(t) % weightCount;
+		std::fill(m_morphWeights.begin(), m_morphWeights.end(), 0.0f);
+		m_morphWeights[target] = sinf(float32(t - floor(t)) * glm::radians(180.0f));
+	}
+
+	//EFCgׂ0ŁÃt[̃obt@̒_̂܂܂Ȃ牽Ȃ
+	bool zero = MorphTargets::IsZero(m_morphWeights.data(), weightCount);
+	if (zero && !m_morphDirty[m_imageIndex])
+	{
+		return;
+	}
+	m_morphDirty[m_imageIndex] = !zero;
+	//Rs[gXLjÖꎞobt@փXLȂ_ʂ
+	if (!m_skinnedBuffersReady.empty())
+	{
+		m_skinnedBuffersReady[m_imageIndex] = false;
+	}
+
+	if (m_morphPipeline == VK_NULL_HANDLE)
+	{
+		//CPUŕ]A_̃t[̃obt@֏(tFX҂ς)
+		morphs.Evaluate(m_morphWeights.data(), m_morphPositions.data(), m_morphNormals.data());
+		void* vertices;
+		void* positions;
+		vkMapMemory(m_vkDevice, m_model.morphVertexBuffers[m_imageIndex].memory, 0, VK_WHOLE_SIZE, 0, &vertices);
+		vkMapMemory(m_vkDevice, m_model.morphPositionBuffers[m_imageIndex].memory, 0, VK_WHOLE_SIZE, 0, &positions);
+		const auto& ranges = morphs.GetRanges();
+		for (uint32 idx=0; idx<morphs.Size(); ++idx)
 		{
-			vkDestroyShaderModule(m_vkDevice, v.module, nullptr);
+			auto& vertex = static_cast<Vertex*>(vertices)[ranges[idx].vertex];
+			vertex.pos = vec3(m_morphPositions[idx]);
+			vertex.color = vec3(m_morphNormals[idx]);
+			static_cast<vec3*>(positions)[ranges[idx].vertex] = vertex.pos;
 		}
+		vkUnmapMemory(m_vkDevice, m_model.morphVertexBuffers[m_imageIndex].memory);
+		vkUnmapMemory(m_vkDevice, m_model.morphPositionBuffers[m_imageIndex].memory);
+		return;
 	}
 
-	//p pCvC̍\z
 	{
-		//ufBO
-		const auto colorWriteAll = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-		VkPipelineColorBlendAttachmentState blendAttachment{};
-		blendAttachment.blendEnable = VK_TRUE;
-		blendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-		blendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-		blendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-		blendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-		blendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
-		blendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
-		blendAttachment.colorWriteMask = colorWriteAll;
-		VkPipelineColorBlendStateCreateInfo cbCi{};
-		cbCi.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-		cbCi.attachmentCount = 1;
-		cbCi.pAttachments = &blendAttachment;
+		auto memory = m_model.morphWeightBuffers[m_imageIndex].memory;
+		void* p;
+		vkMapMemory(m_vkDevice, memory, 0, VK_WHOLE_SIZE, 0, &p);
+		memcpy(p, m_morphWeights.data(), sizeof(float32) * weightCount);
+		vkUnmapMemory(m_vkDevice, memory);
+	}
+	uint32 count = morphs.Size();
+	vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_COMPUTE, m_morphPipeline);
+	vkCmdBindDescriptorSets(command, VK_PIPELINE_BIND_POINT_COMPUTE, m_morphPipelineLayout, 0, 1, &m_morphDescriptorSets[m_imageIndex], 0, nullptr);
+	vkCmdPushConstants(command, m_morphPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(count), &count);
+	vkCmdDispatch(command, (count + 63) / 64, 1, 1);
 
-		//fvXXeVXe[g
-		VkPipelineDepthStencilStateCreateInfo depthStencilCi{};
-		depthStencilCi.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-		depthStencilCi.depthTestEnable = VK_TRUE;
-		depthStencilCi.depthCompareOp = VK_COMPARE_OP_LESS_OR_EQUAL;
-		depthStencilCi.depthWriteEnable = VK_TRUE;
-		depthStencilCi.stencilTestEnable = VK_FALSE;
+	{
+		//_́EXLjOEꎞobt@ւ̃Rs[œǂޑOɏ݂҂
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+		vkCmdPipelineBarrier(command, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+}
 
-		//VF[_[ǂݍ
-		vector<VkPipelineShaderStageCreateInfo> shaderStages
-		{
-			_LoadShaderModule(L"shader\\texshaderUv.vert.spv", VK_SHADER_STAGE_VERTEX_BIT),
-			_LoadShaderModule(L"shader\\texshaderAlpha.frag.spv", VK_SHADER_STAGE_FRAGMENT_BIT),
-		};
-		//pCvC\z
-		VkGraphicsPipelineCreateInfo ci{};
-		ci.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-		ci.stageCount = uint32(shaderStages.size());
-		ci.pStages = shaderStages.data();
-		ci.pInputAssemblyState = &inputAssemblyCi;
-		ci.pVertexInputState = &vertexInputCi;
-		ci.pRasterizationState = &rasterizerCi;
-		ci.pDepthStencilState = &depthStencilCi;
-		ci.pMultisampleState = &multisampleCi;
-		ci.pViewportState = &viewportCi;
-		ci.pColorBlendState = &cbCi;
-		ci.renderPass = m_renderPass;
-		ci.layout = m_pipelineLayout;
-		vkCreateGraphicsPipelines(m_vkDevice, VK_NULL_HANDLE, 1, &ci, nullptr, &m_pipelineAlpha);
+VkBuffer ModelApp::
+_GetMorphedVertexBuffer(uint32 imageIndex) const
+{
+	return m_model.morphVertexBuffers.empty() ? m_model.vertexBuffer.buffer : m_model.morphVertexBuffers[imageIndex].buffer;
+}
 
-		for (const auto& v : shaderStages)
-		{
-			vkDestroyShaderModule(m_vkDevice, v.module, nullptr);
-		}
-	}
+VkBuffer ModelApp::
+_GetMorphedPositionBuffer(uint32 imageIndex) const
+{
+	return m_model.morphPositionBuffers.empty() ? m_model.positionBuffer.buffer : m_model.morphPositionBuffers[imageIndex].buffer;
 }
 
 void ModelApp::
-cleanup(void)
+_CreateSkinningBuffers(Model& model)
 {
-	for (auto& v : m_uniformBuffers)
+	//֐ߍs̓XLĂ1͒uAfBXNv^ɗLɂĂ
+	const VkMemoryPropertyFlags hostFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	const uint32 frameCount = uint32(m_swapchainViews.size());
+	const vector<mat4> jointMatrices((std::max)(model.skins.Size(), 1u), mat4(1.0f));
+	model.jointBuffers.resize(frameCount);
+	for (auto& v : model.jointBuffers)
 	{
-		vkDestroyBuffer(m_vkDevice, v.buffer, nullptr);
-		vkFreeMemory(m_vkDevice, v.memory, nullptr);
+		v = _CreateBufferObj(uint32(sizeof(mat4) * jointMatrices.size()), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT, hostFlags, jointMatrices.data());
+	}
+	if (model.skinnedRanges.empty())
+	{
+		return;
 	}
-	vkDestroySampler(m_vkDevice, m_sampler, nullptr);
 
-	vkDestroyPipelineLayout(m_vkDevice, m_pipelineLayout, nullptr);
-	vkDestroyPipeline(m_vkDevice, m_pipelineOpaque, nullptr);
-	vkDestroyPipeline(m_vkDevice, m_pipelineAlpha, nullptr);
+	//XLjOς݂̒_̓t[Ƃ̈ꎞobt@֏
+	const uint32 vbSize = uint32(sizeof(Vertex) * model.vertexCount);
+	const uint32 posSize = uint32(sizeof(float32) * 3 * model.vertexCount);
+	const VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+	model.skinnedVertexBuffers.resize(frameCount);
+	model.skinnedPositionBuffers.resize(frameCount);
+	for (uint32 idx=0; idx<frameCount; ++idx)
+	{
+		model.skinnedVertexBuffers[idx] = _CreateBufferObj(vbSize, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, nullptr);
+		model.skinnedPositionBuffers[idx] = _CreateBufferObj(posSize, usage, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, nullptr);
+	}
+}
 
-	for (auto& mesh : m_model.meshes)
+void ModelApp::
+_CreateSkinning(void)
+{
+	const uint32 frameCount = uint32(m_swapchainViews.size());
+	m_jointMatrices.assign((std::max)(m_model.skins.Size(), 1u), mat4(1.0f));
+	if (m_model.skinnedRanges.empty() || m_skinPipeline == VK_NULL_HANDLE)
 	{
-		vkFreeMemory(m_vkDevice, mesh.vertexBuffer.memory, nullptr);
-		vkFreeMemory(m_vkDevice, mesh.indexBuffer.memory, nullptr);
-		vkDestroyBuffer(m_vkDevice, mesh.vertexBuffer.buffer, nullptr);
-		vkDestroyBuffer(m_vkDevice, mesh.indexBuffer.buffer, nullptr);
-		uint32 count = uint32(mesh.descriptoreSet.size());
-		mesh.descriptoreSet.clear();
+		return;
 	}
-	for (auto& material : m_model.materials)
+	m_skinnedBuffersReady.assign(frameCount, false);
+
+	m_skinDescriptorSets.resize(frameCount);
+	for (uint32 idx=0; idx<frameCount; ++idx)
 	{
-		vkFreeMemory(m_vkDevice, material.texture.memory, nullptr);
-		vkDestroyImage(m_vkDevice, material.texture.image, nullptr);
-		vkDestroyImageView(m_vkDevice, material.texture.view, nullptr);
+		m_skinDescriptorSets[idx] = m_descriptors.Allocate(m_skinDescriptorSetLayout);
+		VkDescriptorBufferInfo infos[] = {
+			{ _GetMorphedVertexBuffer(idx), 0, VK_WHOLE_SIZE },
+			{ m_model.skinBuffer.buffer, 0, VK_WHOLE_SIZE },
+			{ m_model.jointBuffers[idx].buffer, 0, VK_WHOLE_SIZE },
+			{ m_model.skinnedVertexBuffers[idx].buffer, 0, VK_WHOLE_SIZE },
+			{ m_model.skinnedPositionBuffers[idx].buffer, 0, VK_WHOLE_SIZE },
+		};
+		array<VkWriteDescriptorSet, 5> writes{};
+		for (uint32 binding=0; binding<uint32(writes.size()); ++binding)
+		{
+			writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[binding].dstSet = m_skinDescriptorSets[idx];
+			writes[binding].dstBinding = binding;
+			writes[binding].descriptorCount = 1;
+			writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+			writes[binding].pBufferInfo = &infos[binding];
+		}
+		vkUpdateDescriptorSets(m_vkDevice, uint32(writes.size()), writes.data(), 0, nullptr);
 	}
+}
 
-	vkDestroyDescriptorPool(m_vkDevice, m_descriptorPool, nullptr);
-	vkDestroyDescriptorSetLayout(m_vkDevice, m_descriptorSetLayout, nullptr);
+void ModelApp::
+_DestroySkinning(void)
+{
+	_RetireDescriptorSets(m_skinDescriptorSetLayout, m_skinDescriptorSets);
+	m_skinDescriptorSets.clear();
+	m_skinnedBuffersReady.clear();
 }
 
 void ModelApp::
-makeCommand(VkCommandBuffer command)
+_DispatchSkinning(VkCommandBuffer command)
 {
-	using namespace Microsoft::glTF;
+	//̃C[WőOvRs[g̎ԂWv(tFX҂ς)
+	if (m_skinQueryPool != VK_NULL_HANDLE && m_skinQueryWritten[m_imageIndex])
+	{
+		uint64 ticks[2] = {};
+		if (vkGetQueryPoolResults(m_vkDevice, m_skinQueryPool, m_imageIndex * 2, 2, sizeof(ticks), ticks, sizeof(uint64), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+		{
+			uint64 elapsed = ((ticks[1] & m_timestampMask) - (ticks[0] & m_timestampMask)) & m_timestampMask;
+			m_skinGpuMs += float64(elapsed) * m_timestampPeriod * 1.0e-6;
+			++m_skinGpuFrames;
+		}
+		m_skinQueryWritten[m_imageIndex] = false;
+	}
 
-	//jtH[obt@XV
-	ShaderParameters shaderParam{};
-	shaderParam.mtxWorld = glm::identity<glm::mat4>();
-	shaderParam.mtxView = lookAtRH(vec3(0.0f, 1.5f, -1.0f), vec3(0.0f, 1.25f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
-	shaderParam.mtxProj = perspective(glm::radians(45.0f), 1280.0f / 720.0f, 0.01f, 100.0f);
+	//֐ߍsXV
+	if (m_model.skins.Size() == 0)
 	{
-		auto memory = m_uniformBuffers[m_imageIndex].memory;
+		return;
+	}
+	m_model.skins.Compute(m_model.scene, m_jointMatrices.data());
+	{
+		auto memory = m_model.jointBuffers[m_imageIndex].memory;
 		void* p;
 		vkMapMemory(m_vkDevice, memory, 0, VK_WHOLE_SIZE, 0, &p);
-		memcpy(p, &shaderParam, sizeof(shaderParam));
+		memcpy(p, m_jointMatrices.data(), sizeof(mat4) * m_jointMatrices.size());
 		vkUnmapMemory(m_vkDevice, memory);
 	}
+	if (!_UseComputeSkinning())
+	{
+		return;
+	}
 
-	for (auto mode : {ALPHA_OPAQUE, ALPHA_MASK, ALPHA_BLEND})
+	//XLȂ_͕ςȂ̂ŁAꎞobt@ւ͏(ƃ[t]Ƃ)ۂƎʂ
+	if (!m_skinnedBuffersReady[m_imageIndex])
 	{
-		for (const auto& mesh : m_model.meshes)
-		{
-			//Ή郁bV݂̂`悷
-			if (m_model.materials[mesh.materialIndex].alphaMode != mode)
-			{
-				continue;
-			}
+		VkBufferCopy vertexCopy{ 0, 0, VkDeviceSize(sizeof(Vertex) * m_model.vertexCount) };
+		VkBufferCopy positionCopy{ 0, 0, VkDeviceSize(sizeof(float32) * 3 * m_model.vertexCount) };
+		vkCmdCopyBuffer(command, _GetMorphedVertexBuffer(m_imageIndex), m_model.skinnedVertexBuffers[m_imageIndex].buffer, 1, &vertexCopy);
+		vkCmdCopyBuffer(command, _GetMorphedPositionBuffer(m_imageIndex), m_model.skinnedPositionBuffers[m_imageIndex].buffer, 1, &positionCopy);
+
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		vkCmdPipelineBarrier(command, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+		m_skinnedBuffersReady[m_imageIndex] = true;
+	}
 
-			//[hɉăpCvCύX
-			switch (mode)
-			{
-			case Microsoft::glTF::ALPHA_OPAQUE:
-				vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineOpaque);
-				break;
-			case Microsoft::glTF::ALPHA_BLEND:
-				vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineOpaque);
-				break;
-			case Microsoft::glTF::ALPHA_MASK:
-				vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineAlpha);
-				break;
+	if (m_skinQueryPool != VK_NULL_HANDLE)
+	{
+		vkCmdResetQueryPool(command, m_skinQueryPool, m_imageIndex * 2, 2);
+		vkCmdWriteTimestamp(command, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_skinQueryPool, m_imageIndex * 2);
+	}
+	vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_COMPUTE, m_skinPipeline);
+	vkCmdBindDescriptorSets(command, VK_PIPELINE_BIND_POINT_COMPUTE, m_skinPipelineLayout, 0, 1, &m_skinDescriptorSets[m_imageIndex], 0, nullptr);
+	for (const auto& range : m_model.skinnedRanges)
+	{
+		vkCmdPushConstants(command, m_skinPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(SkinnedRange), &range);
+		vkCmdDispatch(command, (range.vertexCount + 63) / 64, 1, 1);
+	}
+	if (m_skinQueryPool != VK_NULL_HANDLE)
+	{
+		vkCmdWriteTimestamp(command, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, m_skinQueryPool, m_imageIndex * 2 + 1);
+		m_skinQueryWritten[m_imageIndex] = true;
+	}
 
-			default:
-				break;
-			}
+	{
+		//_͂ƂēǂޑOɏ݂҂
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
+		vkCmdPipelineBarrier(command, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+}
 
-			//obt@IuWFNg̃Zbg
-			VkDeviceSize offset = 0;
-			vkCmdBindVertexBuffers(command, 0, 1, &mesh.vertexBuffer.buffer, &offset);
-			vkCmdBindIndexBuffer(command, mesh.indexBuffer.buffer, offset, VK_INDEX_TYPE_UINT32);
+void ModelApp::
+_CreateDepthPyramid(void)
+{
+	//ŏi͐[xobt@̔Aȍ~1x1܂ŔɂĂ(̗]͒[̃eNZ֊܂߂)
+	auto& pyramid = m_depthPyramid;
+	VkExtent2D extent{ (std::max)(m_swapchainExtent.width / 2, 1u), (std::max)(m_swapchainExtent.height / 2, 1u) };
+	pyramid.mipExtents.clear();
+	while (true)
+	{
+		pyramid.mipExtents.push_back(extent);
+		if (extent.width == 1 && extent.height == 1)
+		{
+			break;
+		}
+		extent = VkExtent2D{ (std::max)(extent.width / 2, 1u), (std::max)(extent.height / 2, 1u) };
+	}
+	const uint32 mipCount = uint32(pyramid.mipExtents.size());
+
+	VkImageCreateInfo ci{};
+	ci.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+	ci.imageType = VK_IMAGE_TYPE_2D;
+	ci.format = VK_FORMAT_R32_SFLOAT;
+	ci.extent = { pyramid.mipExtents[0].width, pyramid.mipExtents[0].height, 1 };
+	ci.mipLevels = mipCount;
+	ci.arrayLayers = 1;
+	ci.samples = VK_SAMPLE_COUNT_1_BIT;
+	ci.tiling = VK_IMAGE_TILING_OPTIMAL;
+	ci.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+	ci.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+	vkCreateImage(m_vkDevice, &ci, nullptr, &pyramid.image);
 
-			//fBXNv^Zbg̃Zbg
-			VkDescriptorSet descriptorSets[] = {
-				mesh.descriptoreSet[m_imageIndex]
-			};
-			vkCmdBindDescriptorSets(command, VK_PIPELINE_BIND_POINT_GRAPHICS, m_pipelineLayout, 0, 1, descriptorSets, 0, nullptr);
+	VkMemoryRequirements reqs;
+	vkGetImageMemoryRequirements(m_vkDevice, pyramid.image, &reqs);
+	VkMemoryAllocateInfo ai{};
+	ai.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+	ai.allocationSize = reqs.size;
+	ai.memoryTypeIndex = _GetMemoryTypeIndex(reqs.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+	vkAllocateMemory(m_vkDevice, &ai, nullptr, &pyramid.memory);
+	vkBindImageMemory(m_vkDevice, pyramid.image, pyramid.memory, 0);
+
+	VkImageViewCreateInfo viewCi{};
+	viewCi.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+	viewCi.image = pyramid.image;
+	viewCi.viewType = VK_IMAGE_VIEW_TYPE_2D;
+	viewCi.format = VK_FORMAT_R32_SFLOAT;
+	viewCi.components = { VK_COMPONENT_SWIZZLE_R, VK_COMPONENT_SWIZZLE_G, VK_COMPONENT_SWIZZLE_B, VK_COMPONENT_SWIZZLE_A };
+	viewCi.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, mipCount, 0, 1 };
+	vkCreateImageView(m_vkDevice, &viewCi, nullptr, &pyramid.view);
+	pyramid.mipViews.resize(mipCount);
+	for (uint32 mip=0; mip<mipCount; ++mip)
+	{
+		viewCi.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, mip, 1, 0, 1 };
+		vkCreateImageView(m_vkDevice, &viewCi, nullptr, &pyramid.mipViews[mip]);
+	}
 
-			//bV̕`
-			vkCmdDrawIndexed(command, mesh.indexCount, 1, 0, 0, 0);
+	//texelFetchœǂނ̂ŕԂȂ
+	VkSamplerCreateInfo samplerCi{};
+	samplerCi.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+	samplerCi.minFilter = VK_FILTER_NEAREST;
+	samplerCi.magFilter = VK_FILTER_NEAREST;
+	samplerCi.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+	samplerCi.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCi.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCi.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+	samplerCi.maxAnisotropy = 1.0f;
+	samplerCi.maxLod = VK_LOD_CLAMP_NONE;
+	vkCreateSampler(m_vkDevice, &samplerCi, nullptr, &m_hizSampler);
+
+	//iƂ̃fBXNv^(ǂݍ݌, ݐ)
+	array<VkDescriptorSetLayoutBinding, 2> bindings{};
+	bindings[0] = { 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr };
+	bindings[1] = { 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1, VK_SHADER_STAGE_COMPUTE_BIT, nullptr };
+	VkDescriptorSetLayoutCreateInfo layoutCi{};
+	layoutCi.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+	layoutCi.bindingCount = uint32(bindings.size());
+	layoutCi.pBindings = bindings.data();
+	vkCreateDescriptorSetLayout(m_vkDevice, &layoutCi, nullptr, &m_hizDescriptorSetLayout);
+
+	array<VkDescriptorPoolSize, 2> poolSizes = {
+		{
+			{ VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, mipCount },
+			{ VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, mipCount },
+		}
+	};
+	VkDescriptorPoolCreateInfo poolCi{};
+	poolCi.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+	poolCi.maxSets = mipCount;
+	poolCi.poolSizeCount = uint32(poolSizes.size());
+	poolCi.pPoolSizes = poolSizes.data();
+	vkCreateDescriptorPool(m_vkDevice, &poolCi, nullptr, &m_hizDescriptorPool);
+
+	vector<VkDescriptorSetLayout> layouts(mipCount, m_hizDescriptorSetLayout);
+	VkDescriptorSetAllocateInfo setAi{};
+	setAi.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+	setAi.descriptorPool = m_hizDescriptorPool;
+	setAi.descriptorSetCount = mipCount;
+	setAi.pSetLayouts = layouts.data();
+	m_hizDescriptorSets.resize(mipCount);
+	vkAllocateDescriptorSets(m_vkDevice, &setAi, m_hizDescriptorSets.data());
+	for (uint32 mip=0; mip<mipCount; ++mip)
+	{
+		//ŏi͐[xobt@Aȍ~1̒i
+		VkDescriptorImageInfo src = (mip == 0) ?
+			VkDescriptorImageInfo{ m_hizSampler, m_depthBufferView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL } :
+			VkDescriptorImageInfo{ m_hizSampler, pyramid.mipViews[mip - 1], VK_IMAGE_LAYOUT_GENERAL };
+		VkDescriptorImageInfo dst{ VK_NULL_HANDLE, pyramid.mipViews[mip], VK_IMAGE_LAYOUT_GENERAL };
+
+		array<VkWriteDescriptorSet, 2> writes{};
+		for (uint32 binding=0; binding<uint32(writes.size()); ++binding)
+		{
+			writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+			writes[binding].dstSet = m_hizDescriptorSets[mip];
+			writes[binding].dstBinding = binding;
+			writes[binding].descriptorCount = 1;
+			writes[binding].descriptorType = bindings[binding].descriptorType;
 		}
+		writes[0].pImageInfo = &src;
+		writes[1].pImageInfo = &dst;
+		vkUpdateDescriptorSets(m_vkDevice, uint32(writes.size()), writes.data(), 0, nullptr);
+	}
+
+	//kpCvC
+	VkPushConstantRange pushRange{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(int32) * 4 };
+	VkPipelineLayoutCreateInfo pipelineLayoutCi{};
+	pipelineLayoutCi.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+	pipelineLayoutCi.setLayoutCount = 1;
+	pipelineLayoutCi.pSetLayouts = &m_hizDescriptorSetLayout;
+	pipelineLayoutCi.pushConstantRangeCount = 1;
+	pipelineLayoutCi.pPushConstantRanges = &pushRange;
+	vkCreatePipelineLayout(m_vkDevice, &pipelineLayoutCi, nullptr, &m_hizPipelineLayout);
+
+	VkComputePipelineCreateInfo pipelineCi{};
+	pipelineCi.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+	pipelineCi.stage = _LoadShaderModule(L"shader\\hiz.comp.spv", VK_SHADER_STAGE_COMPUTE_BIT);
+	pipelineCi.layout = m_hizPipelineLayout;
+	vkCreateComputePipelines(m_vkDevice, VK_NULL_HANDLE, 1, &pipelineCi, nullptr, &m_hizPipeline);
+	vkDestroyShaderModule(m_vkDevice, pipelineCi.stage.module, nullptr);
+
+	//CPUJOpɂ͕160x̒iǂݖ߂
+	m_hizReadbackLevel = 0;
+	while (m_hizReadbackLevel + 1 < mipCount && pyramid.mipExtents[m_hizReadbackLevel].width > 160)
+	{
+		++m_hizReadbackLevel;
 	}
+	const auto& readbackExtent = pyramid.mipExtents[m_hizReadbackLevel];
+	const uint32 frameCount = uint32(m_swapchainViews.size());
+	m_hizReadbackBuffers.resize(frameCount);
+	for (auto& v : m_hizReadbackBuffers)
+	{
+		v = _CreateBufferObj(uint32(readbackExtent.width * readbackExtent.height * sizeof(float32)), VK_BUFFER_USAGE_TRANSFER_DST_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, nullptr);
+	}
+	m_hizReadbackViewProj.assign(frameCount, mat4(1.0f));
+	m_hizReadbackValid.assign(frameCount, false);
+	m_depthHistory = false;
 }
 
 void ModelApp::
-_CreateModelGeometry(const Microsoft::glTF::Document& doc, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader)
+_DestroyDepthPyramid(void)
 {
-	using namespace Microsoft::glTF;
-	for (const auto& mesh : doc.meshes.Elements())
+	auto& pyramid = m_depthPyramid;
+	vkDestroyPipeline(m_vkDevice, m_hizPipeline, nullptr);
+	vkDestroyPipelineLayout(m_vkDevice, m_hizPipelineLayout, nullptr);
+	vkDestroyDescriptorPool(m_vkDevice, m_hizDescriptorPool, nullptr);
+	vkDestroyDescriptorSetLayout(m_vkDevice, m_hizDescriptorSetLayout, nullptr);
+	m_hizDescriptorSets.clear();
+	vkDestroySampler(m_vkDevice, m_hizSampler, nullptr);
+
+	for (auto& v : pyramid.mipViews)
 	{
-		for (const auto& meshPrimitive : mesh.primitives)
-		{
-			std::vector<Vertex> vertices;
-			std::vector<uint32> indices;
+		vkDestroyImageView(m_vkDevice, v, nullptr);
+	}
+	pyramid.mipViews.clear();
+	vkDestroyImageView(m_vkDevice, pyramid.view, nullptr);
+	vkDestroyImage(m_vkDevice, pyramid.image, nullptr);
+	vkFreeMemory(m_vkDevice, pyramid.memory, nullptr);
 
-			//_ʒu擾
-			auto& idPos = meshPrimitive.GetAttributeAccessorId(ACCESSOR_POSITION);
-			auto& accPos = doc.accessors.Get(idPos);
-			//@̎擾
-			auto& idNrm = meshPrimitive.GetAttributeAccessorId(ACCESSOR_NORMAL);
-			auto& accNrm = doc.accessors.Get(idNrm);
-			//UVW̎擾
-			auto& idUv = meshPrimitive.GetAttributeAccessorId(ACCESSOR_TEXCOORD_0);
-			auto& accUv = doc.accessors.Get(idUv);
-			//_CfbNX̎擾
-			auto& idIdx = meshPrimitive.indicesAccessorId;
-			auto& accIdx = doc.accessors.Get(idIdx);
+	for (auto& v : m_hizReadbackBuffers)
+	{
+		vkDestroyBuffer(m_vkDevice, v.buffer, nullptr);
+		vkFreeMemory(m_vkDevice, v.memory, nullptr);
+	}
+	m_hizReadbackBuffers.clear();
+	m_hizReadbackValid.clear();
+	m_hizBuffer.Invalidate();
+}
 
-			//f[^擾
-			auto vertPos = reader->ReadBinaryData<float32>(doc, accPos);
-			auto vertNrm = reader->ReadBinaryData<float32>(doc, accNrm);
-			auto vertUv = reader->ReadBinaryData<float32>(doc, accUv);
+bool ModelApp::
+_BuildDepthPyramid(VkCommandBuffer command)
+{
+	auto& pyramid = m_depthPyramid;
+	if (m_hizPipeline == VK_NULL_HANDLE)
+	{
+		return false;
+	}
+	const uint32 mipCount = uint32(pyramid.mipExtents.size());
 
-			auto vertCount = accPos.count;
-			for (uint32 idx=0; idx<vertCount; ++idx)
-			{
-				//_f[^̍\z
-				int32 vid0 = 3 * idx, vid1 = 3 * idx + 1, vid2 = 3 * idx + 2;
-				int32 tid0 = 2 * idx, tid1 = 2 * idx + 1;
-				vertices.emplace_back(
-					Vertex{
-						vec3(vertPos[vid0], vertPos[vid1], vertPos[vid2]),
-						vec3(vertNrm[vid0], vertNrm[vid1], vertNrm[vid2]),
-						vec2(vertUv[tid0], vertUv[tid1])
-					}
-				);
-			}
+	//Ot[̐[x݂ƁAOt[̃s~bhǂݍ݁Eǂݖ߂҂
+	array<VkImageMemoryBarrier, 2> barriers{};
+	for (auto& b : barriers)
+	{
+		b.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		b.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		b.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+	}
+	barriers[0].image = pyramid.image;
+	barriers[0].subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, mipCount, 0, 1 };
+	barriers[0].oldLayout = m_depthHistory ? VK_IMAGE_LAYOUT_GENERAL : VK_IMAGE_LAYOUT_UNDEFINED;
+	barriers[0].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+	barriers[0].srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+	barriers[0].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+	barriers[1].image = m_depthBuffer;
+	barriers[1].subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 };
+	barriers[1].oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	barriers[1].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	barriers[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	barriers[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+	//͐[xobt@ɉ`ĂȂ̂ŃCAEg̏s
+	uint32 barrierCount = m_depthHistory ? 2 : 1;
+	VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+	vkCmdPipelineBarrier(command, srcStage, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 0, nullptr, 0, nullptr, barrierCount, barriers.data());
+	if (!m_depthHistory)
+	{
+		return false;
+	}
 
-			//CfbNX̍\z
-			indices = reader->ReadBinaryData<uint32>(doc, accIdx);
-			auto vbSize = uint32(sizeof(Vertex) * vertices.size());
-			auto idSize = uint32(sizeof(uint32) * indices.size());
-			ModelMesh mesh;
-			mesh.vertexBuffer = _CreateBufferObj(vbSize, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, vertices.data());
-			mesh.indexBuffer = _CreateBufferObj(idSize, VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, indices.data());
-			mesh.vertexCount = uint32(vertices.size());
-			mesh.indexCount = uint32(indices.size());
-			mesh.materialIndex = int32(doc.materials.GetIndex(meshPrimitive.materialId));
-			m_model.meshes.push_back(mesh);
-		}
+	//1ik
+	vkCmdBindPipeline(command, VK_PIPELINE_BIND_POINT_COMPUTE, m_hizPipeline);
+	VkExtent2D srcExtent = m_swapchainExtent;
+	for (uint32 mip=0; mip<mipCount; ++mip)
+	{
+		const auto& dstExtent = pyramid.mipExtents[mip];
+		int32 sizes[4] = { int32(srcExtent.width), int32(srcExtent.height), int32(dstExtent.width), int32(dstExtent.height) };
+		vkCmdBindDescriptorSets(command, VK_PIPELINE_BIND_POINT_COMPUTE, m_hizPipelineLayout, 0, 1, &m_hizDescriptorSets[mip], 0, nullptr);
+		vkCmdPushConstants(command, m_hizPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(sizes), sizes);
+		vkCmdDispatch(command, (dstExtent.width + 7) / 8, (dstExtent.height + 7) / 8, 1);
+
+		VkImageMemoryBarrier mipBarrier = barriers[0];
+		mipBarrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, mip, 1, 0, 1 };
+		mipBarrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+		mipBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		mipBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_TRANSFER_READ_BIT;
+		vkCmdPipelineBarrier(command, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &mipBarrier);
+		srcExtent = dstExtent;
+	}
+
+	//CPUJOpɑeiǂݖ߂(̃R}hobt@̃tFX҂ɎQƂ)
+	{
+		const auto& extent = pyramid.mipExtents[m_hizReadbackLevel];
+		VkBufferImageCopy region{};
+		region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, m_hizReadbackLevel, 0, 1 };
+		region.imageExtent = { extent.width, extent.height, 1 };
+		vkCmdCopyImageToBuffer(command, pyramid.image, VK_IMAGE_LAYOUT_GENERAL, m_hizReadbackBuffers[m_imageIndex].buffer, 1, &region);
+
+		VkBufferMemoryBarrier hostBarrier{};
+		hostBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		hostBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		hostBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		hostBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		hostBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		hostBarrier.buffer = m_hizReadbackBuffers[m_imageIndex].buffer;
+		hostBarrier.size = VK_WHOLE_SIZE;
+		vkCmdPipelineBarrier(command, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT, 0, 0, nullptr, 1, &hostBarrier, 0, nullptr);
+		m_hizReadbackViewProj[m_imageIndex] = m_prevViewProj;
+		m_hizReadbackValid[m_imageIndex] = true;
 	}
+
+	//ǂݏI[xobt@̃t[̕`ɖ߂
+	VkImageMemoryBarrier depthBarrier = barriers[1];
+	depthBarrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+	depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+	depthBarrier.srcAccessMask = 0;
+	depthBarrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	vkCmdPipelineBarrier(command, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT, 0, 0, nullptr, 0, nullptr, 1, &depthBarrier);
+	return true;
 }
 
 void ModelApp::
-_CreateModelMaterial(const Microsoft::glTF::Document& doc, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader)
+_ReadBackDepthPyramid(void)
 {
-	for (auto& m : doc.materials.Elements())
+	//̃C[W̃R}hobt@̓tFX҂ς݂Ȃ̂ŁAOς񂾓ǂݖ߂͊Ă
+	if (m_hizReadbackValid.empty() || !m_hizReadbackValid[m_imageIndex])
 	{
-		auto textureId = m.metallicRoughness.baseColorTexture.textureId;
-		if (textureId.empty())
-		{
-			textureId = m.normalTexture.textureId;
-		}
-		auto& texture = doc.textures.Get(textureId);
-		auto& image = doc.images.Get(texture.imageId);
-		auto imageBufferView = doc.bufferViews.Get(image.bufferViewId);
-		auto imageData = reader->ReadBinaryData<char>(doc, imageBufferView);
-
-		//imageDataeNX`𐶐
-		Material material{};
-		material.alphaMode = m.alphaMode;
-		material.texture = _CreateTextureFromMemory(imageData);
-		m_model.materials.push_back(material);
+		m_hizBuffer.Invalidate();
+		return;
 	}
+	const auto& extent = m_depthPyramid.mipExtents[m_hizReadbackLevel];
+	auto memory = m_hizReadbackBuffers[m_imageIndex].memory;
+	void* p;
+	vkMapMemory(m_vkDevice, memory, 0, VK_WHOLE_SIZE, 0, &p);
+	m_hizBuffer.Update(reinterpret_cast<const float32*>(p), extent.width, extent.height, 2u << m_hizReadbackLevel, m_swapchainExtent.width, m_swapchainExtent.height, m_hizReadbackViewProj[m_imageIndex]);
+	vkUnmapMemory(m_vkDevice, memory);
 }
 
 void ModelApp::
@@ -415,102 +3221,166 @@ _CreateUniformBuffers(void)
 }
 
 void ModelApp::
-_CreateDescriptorSetLayout(void)
+_CreateInstanceBuffers(void)
 {
-	vector<VkDescriptorSetLayoutBinding> bindings;
-	VkDescriptorSetLayoutBinding bindingUBO{}, bindingTex{};
-	bindingUBO.binding = 0;
-	bindingUBO.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	bindingUBO.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-	bindingUBO.descriptorCount = 1;
-	bindings.push_back(bindingUBO);
-
-	bindingTex.binding = 1;
-	bindingTex.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-	bindingTex.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
-	bindingTex.descriptorCount = 1;
-	bindings.push_back(bindingTex);
-
-	VkDescriptorSetLayoutCreateInfo ci{};
-	ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-	ci.bindingCount = uint32(bindings.size());
-	ci.pBindings = bindings.data();
-	vkCreateDescriptorSetLayout(m_vkDevice, &ci, nullptr, &m_descriptorSetLayout);
+	//QOłȂΒPʍsE1u
+	CrowdScene::InstanceData single{};
+	single.world = mat4(1.0f);
+	single.tint = vec4(1.0f);
+	uint32 count = (std::max)(m_crowdSize, 1u);
+	m_instanceBuffers.resize(m_swapchainViews.size());
+	for (auto& v : m_instanceBuffers)
+	{
+		VkMemoryPropertyFlags flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+		v = _CreateBufferObj(uint32(sizeof(CrowdScene::InstanceData) * count), VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, flags, (m_crowdSize > 0) ? nullptr : &single);
+	}
 }
 
 void ModelApp::
-_CreateDescriptorPool(void)
+_CreateDescriptorSetLayout(void)
 {
-	array<VkDescriptorPoolSize, 2> descPoolSize;
-	descPoolSize[0].descriptorCount = 1;
-	descPoolSize[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-	descPoolSize[1].descriptorCount = 1;
-	descPoolSize[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+	//Zbg0 t[Ƃ̃JƊ֐
+	{
+		array<VkDescriptorSetLayoutBinding, 2> bindings{};
+		bindings[0].binding = 0;
+		bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		bindings[0].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+		bindings[0].descriptorCount = 1;
+		bindings[1].binding = 1;
+		bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		bindings[1].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+		bindings[1].descriptorCount = 1;
+		m_frameSetLayout = m_descriptors.GetLayout(bindings.data(), uint32(bindings.size()));
+	}
 
-	uint32 maxDescriptorCount = uint32(m_swapchainImages.size() * m_model.meshes.size());
-	VkDescriptorPoolCreateInfo ci{};
-	ci.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-	ci.maxSets = maxDescriptorCount;
-	ci.poolSizeCount = uint32(descPoolSize.size());
-	ci.pPoolSizes = descPoolSize.data();
-	vkCreateDescriptorPool(m_vkDevice, &ci, nullptr, &m_descriptorPool);
+	//Zbg1 }eÃeNX`(oChXł͑S}eA̔z)
+	{
+		VkDescriptorSetLayoutBinding bindingTex{};
+		bindingTex.binding = 0;
+		bindingTex.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		bindingTex.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+		bindingTex.descriptorCount = m_bindless ? m_bindlessCapacity : 1;
+
+		//oChX̃eNX`z̓}eAɎg
+		//g񂵂ZbǧɑÕf̃eNX`cĂĂAQƂȂ΂悢
+		VkDescriptorBindingFlagsEXT bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT;
+		m_materialSetLayout = m_descriptors.GetLayout(&bindingTex, 1, m_bindless ? &bindingFlags : nullptr);
+	}
 }
 
 void ModelApp::
 _CreateDescriptorSet(void)
 {
-	vector<VkDescriptorSetLayout> layouts;
-	for (uint32 idx=0; idx<uint32(m_uniformBuffers.size()); ++idx)
+	//Zbg0̓C[WƂ1
+	m_frameDescriptorSets.resize(m_uniformBuffers.size());
+	for (auto& v : m_frameDescriptorSets)
 	{
-		layouts.push_back(m_descriptorSetLayout);
+		v = m_descriptors.Allocate(m_frameSetLayout);
 	}
 
-	for (auto& mesh : m_model.meshes)
+	for (uint32 idx=0; idx<uint32(m_frameDescriptorSets.size()); ++idx)
 	{
-		//fBXNv^Zbg̊m
-		VkDescriptorSetAllocateInfo ai{};
-		ai.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-		ai.descriptorPool = m_descriptorPool;
-		ai.descriptorSetCount = uint32(m_uniformBuffers.size());
-		ai.pSetLayouts = layouts.data();
-		mesh.descriptoreSet.resize(m_uniformBuffers.size());
-		vkAllocateDescriptorSets(m_vkDevice, &ai, mesh.descriptoreSet.data());
+		VkDescriptorBufferInfo descUbo{};
+		descUbo.buffer = m_uniformBuffers[idx].buffer;
+		descUbo.offset = 0;
+		descUbo.range = VK_WHOLE_SIZE;
+
+		VkDescriptorBufferInfo descJoints{};
+		descJoints.buffer = m_model.jointBuffers[idx].buffer;
+		descJoints.offset = 0;
+		descJoints.range = VK_WHOLE_SIZE;
+
+		VkWriteDescriptorSet ubo{};
+		ubo.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		ubo.dstBinding = 0;
+		ubo.descriptorCount = 1;
+		ubo.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+		ubo.pBufferInfo = &descUbo;
+		ubo.dstSet = m_frameDescriptorSets[idx];
+
+		VkWriteDescriptorSet joints{};
+		joints.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		joints.dstBinding = 1;
+		joints.descriptorCount = 1;
+		joints.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+		joints.pBufferInfo = &descJoints;
+		joints.dstSet = m_frameDescriptorSets[idx];
+
+		vector<VkWriteDescriptorSet> writeSets = {
+			ubo, joints
+		};
+		vkUpdateDescriptorSets(m_vkDevice, uint32(writeSets.size()), writeSets.data(), 0, nullptr);
+	}
 
-		//fBXNv^Zbg֏
-		auto material = m_model.materials[mesh.materialIndex];
-		for (uint32 idx=0; idx<uint32(m_uniformBuffers.size()); ++idx)
-		{
-			VkDescriptorBufferInfo descUbo{};
-			descUbo.buffer = m_uniformBuffers[idx].buffer;
-			descUbo.offset = 0;
-			descUbo.range = VK_WHOLE_SIZE;
+	_CreateMaterialDescriptorSets();
+
+	//ւ̑OŁAVɊmۂƎg񂵂ׂ悤ɂ
+	const auto& stats = m_descriptors.GetStats();
+	std::stringstream ss;
+	ss << "[ModelApp] descriptor sets: " << m_frameDescriptorSets.size() << " frame + "
+		<< (m_bindless ? 1 : m_model.materials.size()) << " material (" << m_model.meshes.size() << " meshes)"
+		<< ", allocator " << stats.pools << " pools " << stats.allocatedSets << " allocated " << stats.recycledSets << " recycled\n";
+	OutputDebugStringA(ss.str().c_str());
+}
 
-			VkDescriptorImageInfo descImg{};
-			descImg.imageView = material.texture.view;
-			descImg.sampler = m_sampler;
-			descImg.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+void ModelApp::
+_CreateMaterialDescriptorSets(void)
+{
+	vector<VkDescriptorImageInfo> descImgs;
+	for (const auto& material : m_model.materials)
+	{
+		VkDescriptorImageInfo descImg{};
+		descImg.imageView = material.texture.view;
+		descImg.sampler = m_sampler;
+		descImg.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		descImgs.push_back(descImg);
+	}
 
-			VkWriteDescriptorSet ubo{};
-			ubo.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			ubo.dstBinding = 0;
-			ubo.descriptorCount = 1;
-			ubo.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-			ubo.pBufferInfo = &descUbo;
-			ubo.dstSet = mesh.descriptoreSet[idx];
+	if (m_bindless)
+	{
+		//}eA̔ԍ̂܂ܔz̔ԍɂȂ
+		m_textureDescriptorSet = m_descriptors.Allocate(m_materialSetLayout);
 
+		if (descImgs.size() > m_bindlessCapacity)
+		{
+			std::stringstream ss;
+			ss << "[ModelApp] " << descImgs.size() << " materials exceed bindless capacity " << m_bindlessCapacity << "\n";
+			OutputDebugStringA(ss.str().c_str());
+			descImgs.resize(m_bindlessCapacity);
+		}
+		if (!descImgs.empty())
+		{
 			VkWriteDescriptorSet tex{};
 			tex.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-			tex.dstBinding = 1;
-			tex.descriptorCount = 1;
+			tex.dstBinding = 0;
+			tex.dstArrayElement = 0;
+			tex.descriptorCount = uint32(descImgs.size());
 			tex.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-			tex.pImageInfo = &descImg;
-			tex.dstSet = mesh.descriptoreSet[idx];
-
-			vector<VkWriteDescriptorSet> writeSets = {
-				ubo, tex
-			};
-			vkUpdateDescriptorSets(m_vkDevice, uint32(writeSets.size()), writeSets.data(), 0, nullptr);
+			tex.pImageInfo = descImgs.data();
+			tex.dstSet = m_textureDescriptorSet;
+			vkUpdateDescriptorSets(m_vkDevice, 1, &tex, 0, nullptr);
 		}
+		return;
+	}
+
+	vector<VkWriteDescriptorSet> writeSets;
+	for (uint32 idx=0; idx<uint32(m_model.materials.size()); ++idx)
+	{
+		auto descriptorSet = m_descriptors.Allocate(m_materialSetLayout);
+		m_model.materials[idx].descriptorSet = descriptorSet;
+
+		VkWriteDescriptorSet tex{};
+		tex.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+		tex.dstBinding = 0;
+		tex.descriptorCount = 1;
+		tex.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+		tex.pImageInfo = &descImgs[idx];
+		tex.dstSet = descriptorSet;
+		writeSets.push_back(tex);
+	}
+	if (!writeSets.empty())
+	{
+		vkUpdateDescriptorSets(m_vkDevice, uint32(writeSets.size()), writeSets.data(), 0, nullptr);
 	}
 }
 
@@ -602,12 +3472,18 @@ _CreateSampler(void)
 }
 
 ModelApp::TextureObj ModelApp::
-_CreateTextureFromMemory(const std::vector<char>& imageData)
+_CreateTextureFromMemory(const std::vector<char>& imageData, TextureUpload& upload)
 {
-	BufferObj stagingBuffer;
+	//[J[Ă 摜ē]֏ނ܂łŁA]R}h_RecordTextureUploadŐς
 	TextureObj texture{};
 	int32 width, height, channels;
-	auto* image = stbi_load_from_memory(reinterpret_cast<const uint8*>(imageData.data()), int32(imageData.size()), &width, &height, &channels, 0);
+	auto* image = stbi_load_from_memory(reinterpret_cast<const uint8*>(imageData.data()), int32(imageData.size()), &width, &height, &channels, STBI_rgb_alpha);
+	if (image == nullptr)
+	{
+		//fR[hłȂ摜͋̃eNX`ԂAĂяoŃOoēǂݍ݂sɂ
+		//(stbi_failure_reason̓vZXŋLȂ̂Ń[J[͓ǂ܂Ȃ)
+		return texture;
+	}
 	auto format = VK_FORMAT_R8G8B8A8_UNORM;
 	{
 		//VkImage
@@ -637,36 +3513,11 @@ _CreateTextureFromMemory(const std::vector<char>& imageData)
 	{
 		uint32 imageSize = width * height * sizeof(uint32);
 		//Xe[WOobt@p
-		stagingBuffer = _CreateBufferObj(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, image);
-	}
-
-	VkBufferImageCopy copyRegion{};
-	copyRegion.imageExtent = { uint32(width), uint32(height), 1 };
-	copyRegion.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
-	VkCommandBuffer command;
-	{
-		VkCommandBufferAllocateInfo ai{};
-		ai.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-		ai.commandBufferCount = 1;
-		ai.commandPool = m_vkCommandPool;
-		ai.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-		vkAllocateCommandBuffers(m_vkDevice, &ai, &command);
+		upload.staging = _CreateBufferObj(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, image);
+		upload.width = uint32(width);
+		upload.height = uint32(height);
 	}
-
-	VkCommandBufferBeginInfo commandBi{};
-	commandBi.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-	vkBeginCommandBuffer(command, &commandBi);
-	
-	_SetImageMemoryBarrier(command, texture.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-	vkCmdCopyBufferToImage(command, stagingBuffer.buffer, texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
-
-	vkEndCommandBuffer(command);
-
-	VkSubmitInfo submitInfo{};
-	submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-	submitInfo.commandBufferCount = 1;
-	submitInfo.pCommandBuffers = &command;
-	vkQueueSubmit(m_vkQueue, 1, &submitInfo, VK_NULL_HANDLE);
+	stbi_image_free(image);
 	{
 		//eNX`QƗpr[𐶐
 		VkImageViewCreateInfo ci{};
@@ -685,17 +3536,20 @@ _CreateTextureFromMemory(const std::vector<char>& imageData)
 		};
 		vkCreateImageView(m_vkDevice, &ci, nullptr, &texture.view);
 	}
-
-	vkDeviceWaitIdle(m_vkDevice);
-	vkFreeCommandBuffers(m_vkDevice, m_vkCommandPool, 1, &command);
-
-	//Xe[WOobt@J
-	vkFreeMemory(m_vkDevice, stagingBuffer.memory, nullptr);
-	vkDestroyBuffer(m_vkDevice, stagingBuffer.buffer, nullptr);
-
 	return texture;
 }
 
+void ModelApp::
+_RecordTextureUpload(VkCommandBuffer command, const TextureObj& texture, const TextureUpload& upload)
+{
+	VkBufferImageCopy copyRegion{};
+	copyRegion.imageExtent = { upload.width, upload.height, 1 };
+	copyRegion.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+	_SetImageMemoryBarrier(command, texture.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+	vkCmdCopyBufferToImage(command, upload.staging.buffer, texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &copyRegion);
+	_SetImageMemoryBarrier(command, texture.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+}
+
 void ModelApp::
 _SetImageMemoryBarrier(VkCommandBuffer command, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout)
 {
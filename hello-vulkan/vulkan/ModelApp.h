@@ -2,6 +2,23 @@
 #define __Vulkan_ModelApp__
 
 #include "vulkan/VulkanAppBase.h"
+#include "vulkan/DescriptorAllocator.h"
+#include "anim/AnimationClip.h"
+#include "anim/CompressedClip.h"
+#include "anim/AnimationPose.h"
+#include "job/JobSystem.h"
+#include "model/MeshletBuilder.h"
+#include "render/BoundsTable.h"
+#include "render/ClusterCuller.h"
+#include "render/CrowdScene.h"
+#include "render/DrawQueue.h"
+#include "render/FrustumCuller.h"
+#include "render/HiZBuffer.h"
+#include "render/LodSelector.h"
+#include "render/MorphTargets.h"
+#include "render/SceneGraph.h"
+#include "render/SkinPalette.h"
+#include "render/TransparencyQueue.h"
 
 namespace Microsoft
 {
@@ -21,7 +38,58 @@ public:
 
 	virtual void prepare(void) override;
 	virtual void cleanup(void) override;
+	virtual void makePrePassCommand(VkCommandBuffer command) override;
 	virtual void makeCommand(VkCommandBuffer command) override;
+	virtual void reportFrameStats(float64 cpuMs, float64 gpuMs) override;
+
+public:
+	//1t[Ŕs`EoCh̐
+	struct DrawStats
+	{
+		uint32 draws;
+		uint32 pipelineBinds;
+		uint32 descriptorBinds;
+
+		void
+		Add(const DrawStats& other)
+		{
+			draws += other.draws;
+			pipelineBinds += other.pipelineBinds;
+			descriptorBinds += other.descriptorBinds;
+		}
+	};
+	const DrawStats&
+	GetDrawStats(void) const { return m_drawStats; }
+	//fcountׂ̕QǑvV[ɂ(initializeOɌĂ)
+	void
+	SetCrowdSize(uint32 count) { m_crowdSize = count; }
+	//}eÃeNX`oChX̔z񂩂(ΉĂΊŎg rp initializeOɌĂ)
+	void
+	SetBindlessEnabled(bool enable) { m_bindlessEnabled = enable; }
+	//bṼJORs[gōsԐڕ`悷邩(CPU GL[ł؂ւ)
+	void
+	SetGpuCullingEnabled(bool enable) { m_gpuCullingEnabled = enable; }
+
+	//LL[ŏɓւ郂f(initializeOɌĂ 1ڂŏɕ\)
+	void
+	AddModelFile(const wchar* fileName) { m_modelFiles.push_back(fileName); }
+
+	//f̓ǂݍݗv̔ԍ(vɑ)
+	typedef uint32 ModelHandle;
+	enum ModelState
+	{
+		ModelLoading,
+		ModelReady,		//`ɎgĂ
+		ModelRetired,	//ւꂽA܂̗͌vɕ\ꂽ̂Ŏ̂Ă
+		ModelFailed,
+	};
+	//fileName(st@C̃fBNg̑΃pX)[J[œǂݍݎn߁Aɖ߂
+	//́EfR[hEobt@ւ݂̏̓[J[ōsAĨt[ŕ`撆̃fƓւ
+	//ւꂽf̎́Agt[̃tFX҂ĂJ
+	ModelHandle
+	LoadModelAsync(const wchar* fileName);
+	ModelState
+	GetModelState(ModelHandle handle) const;
 
 private:
 	struct Vertex
@@ -47,41 +115,330 @@ private:
 		glm::mat4 mtxView;
 		glm::mat4 mtxProj;
 	};
-	struct ModelMesh
+	//`悲Ƃ̃vbV萔
+	struct DrawParameters
 	{
-		BufferObj vertexBuffer;
-		BufferObj indexBuffer;
+		glm::mat4 mtxNodeWorld;
+		uint32 skinning;		//_VF[_[ŃXLjO邩
+		uint32 material;		//oChX̃eNX`z̔ԍ
+		uint32 padding[2];
+	};
+	//XLjOsꏊ
+	enum SkinningMode
+	{
+		SkinningVertex,		//`̂тɒ_VF[_[
+		SkinningCompute,	//t[̍ŏɃRs[gňꎞ_obt@
+	};
+	//XLbV̒_͈(L_obt@)
+	struct SkinnedRange
+	{
+		uint32 firstVertex;
 		uint32 vertexCount;
+	};
+	struct Camera
+	{
+		glm::vec3 eye;
+		float32 fovY;
+		glm::mat4 view;
+		glm::mat4 proj;
+	};
+	struct MeshLod
+	{
+		uint32 firstIndex;		//LCfbNXobt@̊Jnʒu
 		uint32 indexCount;
+		float32 error;			//LOD0ɑ΂덷(bVO`)
+	};
+	struct ModelMesh
+	{
+		uint32 vertexOffset;	//L_obt@̊Jnʒu
+		uint32 vertexCount;
+		uint32 node;			//[hsV[̃m[h
+		bool skinned;
 		int32 materialIndex;
-		std::vector<VkDescriptorSet> descriptoreSet;
+		std::vector<Meshlet> meshlets;	//LOD0̂
+		std::vector<MeshLod> lods;
 	};
 	struct Material 
 	{
 		TextureObj texture;
 		Microsoft::glTF::AlphaMode alphaMode;
+		bool doubleSided;
+		VkDescriptorSet descriptorSet;	//Zbg1(oChXł͎gȂ)
+	};
+	//pCvCE}eAł܂Ƃ߂ĊԐڕ`悷͈
+	struct DrawBucket
+	{
+		Microsoft::glTF::AlphaMode mode;
+		uint32 meshIndex;	//fBXNv^Zbg؂\bV
+		uint32 drawBase;	//Ԑڕ`obt@̊Jnʒu
+		uint32 capacity;
+	};
+	//GPUJO̓(cull.compInstanceƓstd430CAEg)
+	struct GpuInstance
+	{
+		glm::vec4 sphere;
+		glm::vec4 aabbMin;
+		glm::vec4 aabbMax;
+		uint32 lodFirstIndex[LodSelector::MaxLods];
+		uint32 lodIndexCount[LodSelector::MaxLods];
+		uint32 info[4];		//LOD, _ItZbg, oPbg, 񈳏k̏ݐ
+		uint32 draw[4];		//oPbg̐擪
 	};
 	struct Model 
 	{
 		std::vector<ModelMesh> meshes;
 		std::vector<Material> materials;
+		BufferObj vertexBuffer;		//SbV̒_l߂Lobt@
+		BufferObj positionBuffer;	//vertexBufferƓт̈ʒû([xvpXp)
+		BufferObj indexBuffer;		//SbVESLOD̃CfbNXl߂Lobt@
+		BufferObj skinBuffer;		//vertexBufferƓт̊֐߁EEFCg(_oCfBO2)
+		uint32 vertexCount;
+		SkinPalette skins;
+		std::vector<SkinnedRange> skinnedRanges;
+		uint32 skinnedNode;			//XLbVuPʍs̃m[h(֐ߍs񂪃[h܂Ŋ܂)
+		MorphTargets morphs;
+		std::vector<float32> morphWeights;	//bVƂ̃^[Qbgׂ̃EFCg
+		SceneGraph scene;			//glTF̃m[hKw
+		std::vector<CompressedClip> clips;	//ʎqNbv(Đk܂)
+		std::vector<uint32> animationNodes;	//Nbv̑Ώ(glTF̃m[hԍ)  scenẽm[h
+		BoundsTable localBounds;	//meshesƓт̃[JԂ̋E
+		BoundsTable bounds;			//localBoundsm[h̃[hsňڂ
+
+		//Rs[gp̃f̑傫̃obt@(t[Ƃ̂̂̓Xbv`FC̃C[W)
+		std::vector<DrawBucket> drawBuckets;			//GPUJO
+		std::vector<GpuInstance> cullInstances;			//E̕ω𔽉fCPU̎ʂ
+		std::vector<uint32> cullInstanceVersions;		//esŌɏboundsVersion
+		uint32 boundsVersion;							//_UpdateWorldBoundŝтɐi
+		std::vector<BufferObj> cullInstanceBuffers;		//t[(gOɌÂsʂ)
+		BufferObj cullLodStateBuffer;
+		std::vector<BufferObj> indirectBuffers;
+		std::vector<BufferObj> drawCountBuffers;
+		std::vector<BufferObj> jointBuffers;			//t[Ƃ̊֐ߍs
+		std::vector<BufferObj> skinnedVertexBuffers;	//t[Ƃ̃XLjOςݒ_(vertexBufferƓ)
+		std::vector<BufferObj> skinnedPositionBuffers;	// ʒû(positionBufferƓ)
+		std::vector<BufferObj> morphVertexBuffers;		//t[Ƃ̃[t̒_(̒_ŏA_)
+		std::vector<BufferObj> morphPositionBuffers;	// ʒû
+		BufferObj morphRangeBuffer;
+		BufferObj morphDeltaBuffer;
+		std::vector<BufferObj> morphWeightBuffers;
+	};
+	//[J[ōeNX`̓](]R}h͕`XbhŐς)
+	struct TextureUpload
+	{
+		BufferObj staging;
+		uint32 width;
+		uint32 height;
+	};
+	//񓯊ǂݍ1
+	//counter0ɂȂ܂ł̓[J[A0ɂȂ͕`XbhG
+	struct ModelLoad
+	{
+		ModelApp* app;
+		ModelHandle handle;
+		std::wstring filePath;
+		Model model;
+		std::vector<std::vector<char>> images;	//}eAƂ̉摜t@C̒g(fR[ĥĂ)
+		std::vector<TextureUpload> uploads;		//}eAƓ
+		JobCounter counter;
+		std::atomic<bool> failed;	//eNX`̃Wu
+	};
+	struct CullParameters
+	{
+		glm::vec4 planes[Frustum::PlaneCount];
+		glm::vec4 eye;		//w:tan(fovY/2)
+		uint32 config[4];	//CX^X, l߂ďނ, Օ肷邩
+		glm::mat4 prevViewProj;
+		glm::vec4 hizInfo;	//xy:[xobt@̃TCY z:s~bh̒i
+	};
+	//Ot[̐[xł̒lŏkĂ~bv`F[
+	struct DepthPyramid
+	{
+		VkImage image;
+		VkDeviceMemory memory;
+		VkImageView view;					//Si
+		std::vector<VkImageView> mipViews;	//i(ݗp)
+		std::vector<VkExtent2D> mipExtents;
+	};
+	//CPUJO̕`P
+	struct DrawItem
+	{
+		Microsoft::glTF::AlphaMode mode;
+		uint32 meshIndex;
+		uint32 firstIndex;
+		uint32 indexCount;
+		uint32 firstInstance;	//CX^Xobt@̊Jnʒu
+		uint32 instanceCount;
+	};
+	//OɃoCh(ςƂςݒ)
+	//R}hobt@ƂɎAς񂾐֐
+	struct BindState
+	{
+		VkPipeline pipeline;
+		int32 material;
+		uint32 node;
+		DrawStats stats;
+	};
+	//ZJ_R}hobt@1{̋L^͈
+	enum SecondaryPass
+	{
+		SecondaryDepthCpu,		//m_drawQueue̕ŝ
+		SecondaryDepthGpu,
+		SecondaryMainCpu,		//m_drawQueue
+		SecondaryMainGpu,
+		SecondaryTransparent,	//m_transparencyQueue
+	};
+	struct SecondaryChunk
+	{
+		SecondaryPass pass;
+		uint32 begin;			//L[͈̔(GPUJOł͎gȂ)
+		uint32 end;
+		VkCommandBuffer command;
+		DrawStats stats;
 	};
 
 
 private:
+	//[J[Ŏsǂݍ(dataModelLoad)
+	static void
+	_LoadModelJob(void* data, uint32 begin, uint32 end);
+	//[begin, end)̃}eẢ摜fR[hăeNX`
+	static void
+	_DecodeTextureJob(void* data, uint32 begin, uint32 end);
+	//ǂݏIfm_modelֈڂAeNX`̓]command֐ς
+	void
+	_PublishLoadedModels(VkCommandBuffer command);
+	//\Ȃǂݍ݌ʂ̂Ă
+	void
+	_DiscardModelLoad(ModelLoad& load);
+	//m_modelɍ킹ăt[Ƃ̎
+	void
+	_CreateModelResources(void);
+	//m_modelƃt[Ƃ̎̂Ă(JGPUgIĂ)
+	void
+	_DestroyModelResources(void);
 	void
-	_CreateModelGeometry(const Microsoft::glTF::Document&, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader);
+	_DestroyModel(Model& model);
 	void
-	_CreateModelMaterial(const Microsoft::glTF::Document&, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader);
+	_RetireBuffers(const std::vector<BufferObj>& buffers);
+	void
+	_RetireDescriptorSets(VkDescriptorSetLayout layout, const std::vector<VkDescriptorSet>& sets);
+
+	//ȉModel󂯎̂̓[J[Ă
+	void
+	_CreateSceneGraph(Model& model, const Microsoft::glTF::Document&, std::vector<uint32>& nodeMap, std::vector<uint32>& meshNodes, std::vector<int32>& meshSkins);
+	void
+	_CreateSkins(Model& model, const Microsoft::glTF::Document&, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader, const std::vector<uint32>& nodeMap);
+	void
+	_CreateModelGeometry(Model& model, const Microsoft::glTF::Document&, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader, const std::vector<uint32>& meshNodes, const std::vector<int32>& meshSkins);
+	void
+	_ReadSkinVertices(const Microsoft::glTF::Document&, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader, const Microsoft::glTF::MeshPrimitive& primitive, uint32 jointOffset, std::vector<SkinPalette::SkinVertex>& skinVertices);
+	void
+	_CreateAnimations(Model& model, const Microsoft::glTF::Document&, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader, const std::vector<uint32>& nodeMap);
+	void
+	_UpdateAnimation(void);
+	void
+	_UpdateWorldBounds(Model& model, bool all);
+	void
+	_AppendModelMesh(Model& model, const std::vector<Vertex>& vertices, uint32 vertexOffset, std::vector<uint32>& indices, int32 materialIndex, const Microsoft::glTF::Accessor* positionAccessor, std::vector<uint32>& arenaIndices);
+	//}eAׁA摜t@C̒gimages֓ǂ
+	void
+	_CreateModelMaterial(Model& model, const Microsoft::glTF::Document&, std::shared_ptr<Microsoft::glTF::GLTFResourceReader> reader, std::vector<std::vector<char>>& images);
+	//Rs[gǂݏ郂f̑傫̃obt@
+	void
+	_CreateGpuCullingBuffers(Model& model);
+	void
+	_CreateMorphingBuffers(Model& model);
+	void
+	_CreateSkinningBuffers(Model& model);
+
+	//Rs[g̃pCvC̓fɂȂ̂prepare1x
+	void
+	_CreateComputePipelines(void);
+	void
+	_DestroyComputePipelines(void);
+
+	//ȉCreatem_model̃obt@wfBXNv^Zbg
+	void
+	_CreateGpuCulling(void);
+	void
+	_DestroyGpuCulling(void);
+
+	void
+	_CreateMorphing(void);
+	void
+	_DestroyMorphing(void);
+	void
+	_DispatchMorphing(VkCommandBuffer command);
+	//[t([tΌ)̒_Eʒuobt@
+	VkBuffer
+	_GetMorphedVertexBuffer(uint32 imageIndex) const;
+	VkBuffer
+	_GetMorphedPositionBuffer(uint32 imageIndex) const;
+
+	void
+	_CreateSkinning(void);
+	void
+	_DestroySkinning(void);
+	void
+	_DispatchSkinning(VkCommandBuffer command);
+	bool
+	_UseComputeSkinning(void) const;
+	bool
+	_UseGpuCulling(void) const;
+
+	void
+	_CreateDepthPyramid(void);
+	void
+	_DestroyDepthPyramid(void);
+	bool
+	_BuildDepthPyramid(VkCommandBuffer command);
+	void
+	_ReadBackDepthPyramid(void);
+	void
+	_DispatchGpuCulling(VkCommandBuffer command, bool occlusion);
+
+	void
+	_UpdateCamera(void);
+	void
+	_CullCpu(bool blendOnly);
+	void
+	_CullCrowd(void);
+	//CfbNXobt@ƒ_oCfBO0`2At[̃fBXNv^ZbgZbg
+	//ZbgfBXNv^Zbg̃oChԂ
+	uint32
+	_BindGeometry(VkCommandBuffer command, VkBuffer vertexBuffer);
+	//L[[begin, end)ς
+	void
+	_DrawCpuCulled(VkCommandBuffer command, bool depthOnly, uint32 begin, uint32 end, BindState& bound);
+	void
+	_DrawTransparent(VkCommandBuffer command, uint32 begin, uint32 end, BindState& bound);
+	void
+	_RecordDrawItem(VkCommandBuffer command, const DrawItem& item, bool depthOnly, BindState& bound);
+	void
+	_BindMaterial(VkCommandBuffer command, int32 material);
+	void
+	_PushDrawParameters(VkCommandBuffer command, uint32 node, int32 material);
+	void
+	_DrawGpuCulled(VkCommandBuffer command, bool depthOnly, BindState& bound);
+	//`惊Xg`NɕA[J[ŃZJ_֋L^ĂcommandŎs
+	void
+	_RecordSecondaryCommands(VkCommandBuffer command, bool gpuCulling, VkBuffer vertexBuffer, VkBuffer positionBuffer);
+	VkPipeline
+	_SelectPipeline(Microsoft::glTF::AlphaMode mode) const;
+	static uint32
+	_GetRenderPass(Microsoft::glTF::AlphaMode mode);
 
 	void
 	_CreateUniformBuffers(void);
 	void
-	_CreateDescriptorSetLayout(void);
+	_CreateInstanceBuffers(void);
 	void
-	_CreateDescriptorPool(void);
+	_CreateDescriptorSetLayout(void);
 	void
 	_CreateDescriptorSet(void);
+	//}eAƂ̃Zbg1(oChXł͑SeNX`̔z1)
+	void
+	_CreateMaterialDescriptorSets(void);
 
 	BufferObj
 	_CreateBufferObj(uint32 size, VkBufferUsageFlags usage, VkMemoryPropertyFlags flags, const void* initialData);
@@ -89,20 +446,120 @@ private:
 	_LoadShaderModule(const wchar* fileName, VkShaderStageFlagBits stage);
 	VkSampler
 	_CreateSampler(void);
+	//[J[Ă ]upload֏
 	TextureObj
-	_CreateTextureFromMemory(const std::vector<char>& imageData);
+	_CreateTextureFromMemory(const std::vector<char>& imageData, TextureUpload& upload);
+	void
+	_RecordTextureUpload(VkCommandBuffer command, const TextureObj& texture, const TextureUpload& upload);
 	void
 	_SetImageMemoryBarrier(VkCommandBuffer command, VkImage image, VkImageLayout oldLayout, VkImageLayout newLayout);
 
 private:
 	Model m_model;
+	bool m_modelReady;					//m_model`悵Ă悢
+	JobSystem m_jobs;
+	std::vector<std::unique_ptr<ModelLoad>> m_modelLoads;	//ǂݍݒ
+	std::vector<ModelState> m_modelStates;					//nh
+	ModelHandle m_shownModel;
+	std::vector<std::wstring> m_modelFiles;
+	uint32 m_modelFile;
+	bool m_swapKeyDown;
 	std::vector<BufferObj> m_uniformBuffers;
-	VkDescriptorSetLayout m_descriptorSetLayout;
-	VkDescriptorPool m_descriptorPool;
+	std::vector<BufferObj> m_instanceBuffers;	//_oCfBO1 QOłȂΒPʍs1̂
+	DescriptorAllocator m_descriptors;				//`ƃRs[g̃Zbg(Hi-Z͎Õv[)
+	VkDescriptorSetLayout m_frameSetLayout;		//Zbg0 JE֐(m_descriptors)
+	VkDescriptorSetLayout m_materialSetLayout;		//Zbg1 eNX`()
+	bool m_bindlessEnabled;
+	bool m_bindless;							//prepareŌ܂(pCvC̃VF[_[ς)
+	uint32 m_bindlessCapacity;					//eNX`z̗vf
+	std::vector<VkDescriptorSet> m_frameDescriptorSets;	//C[WƂ̃Zbg0
+	VkDescriptorSet m_textureDescriptorSet;				//oChX̃Zbg1
 	VkSampler m_sampler;
 	VkPipelineLayout m_pipelineLayout;
 	VkPipeline m_pipelineOpaque;
 	VkPipeline m_pipelineAlpha;
+	VkPipeline m_pipelineDepth;			//[xvpX
+	VkPipeline m_pipelineOpaqueEqual;	//[xvpX̕s(EQUALrE[x݂Ȃ)
+	VkPipeline m_pipelineBlend;			//([x݂Ȃ)
+	bool m_depthPrePass;
+	bool m_prePassKeyDown;
+	SkinningMode m_skinningMode;
+	bool m_skinningKeyDown;
+	bool m_morphDemo;					//^[Qbg1
+	bool m_morphKeyDown;
+	AnimationPose m_animationPose;
+	std::vector<float32> m_animationTimes;				//NbvƂ̍Đʒu
+	std::vector<std::vector<uint32>> m_animationCursors;	//NbvƂ̃gbÑJ[\
+	uint32 m_animationClip;
+	uint32 m_animationFadeFrom;			//NXtF[ȟ̃Nbv(~0)
+	float32 m_animationFade;			//0`1
+	float64 m_animationLastTime;
+	bool m_animationKeyDown;
+	Camera m_camera;
+
+	std::vector<uint32> m_visibleMeshes;
+	std::vector<DrawItem> m_drawItems;
+	DrawQueue m_drawQueue;				//m_drawItemŝsEAt@eXg`揇ɕׂ
+	TransparencyQueue m_transparencyQueue;	//m_drawItemŝ珇ɕׂ
+	DrawStats m_drawStats;
+	std::vector<SecondaryChunk> m_secondaryChunks;
+	bool m_secondaryKeyDown;
+
+	//QǑvV[
+	uint32 m_crowdSize;
+	CrowdScene m_crowd;
+	uint32 m_crowdVisible;
+	std::vector<DrawRange> m_drawRanges;
+	std::vector<uint32> m_meshLods;
+
+	//GPUJO
+	bool m_gpuCullingEnabled;
+	bool m_gpuCullingKeyDown;
+	bool m_gpuCulling;					//pCvCƃZbgĂ
+	std::vector<BufferObj> m_cullParamBuffers;
+	VkDescriptorSetLayout m_cullDescriptorSetLayout;	//m_descriptors(XLjOE[t)
+	std::vector<VkDescriptorSet> m_cullDescriptorSets;
+	std::vector<uint32> m_cullUploadVersions;	//C[WƂɓ̓obt@֎ʂIboundsVersion
+	VkPipelineLayout m_cullPipelineLayout;
+	VkPipeline m_cullPipeline;
+	PFN_vkCmdDrawIndexedIndirectCountKHR m_vkCmdDrawIndexedIndirectCountKHR;
+
+	//XLjO
+	std::vector<glm::mat4> m_jointMatrices;
+	std::vector<bool> m_skinnedBuffersReady;			//XLȂ_ʂI
+	VkDescriptorSetLayout m_skinDescriptorSetLayout;
+	std::vector<VkDescriptorSet> m_skinDescriptorSets;
+	VkPipelineLayout m_skinPipelineLayout;
+	VkPipeline m_skinPipeline;
+	VkQueryPool m_skinQueryPool;						//Rs[g̑Õ^CX^v
+	std::vector<bool> m_skinQueryWritten;
+	float64 m_skinGpuMs;
+	uint32 m_skinGpuFrames;
+
+	std::vector<float32> m_morphWeights;				//̃t[̃EFCg
+	std::vector<bool> m_morphDirty;						//̒_ςĂ邩
+	std::vector<glm::vec4> m_morphPositions;			//CPU]̌
+	std::vector<glm::vec4> m_morphNormals;
+	VkDescriptorSetLayout m_morphDescriptorSetLayout;
+	std::vector<VkDescriptorSet> m_morphDescriptorSets;
+	VkPipelineLayout m_morphPipelineLayout;
+	VkPipeline m_morphPipeline;							//ȂCPUŕ]
+
+	//Hi-ZՕJO
+	DepthPyramid m_depthPyramid;
+	VkSampler m_hizSampler;
+	VkDescriptorSetLayout m_hizDescriptorSetLayout;
+	VkDescriptorPool m_hizDescriptorPool;
+	std::vector<VkDescriptorSet> m_hizDescriptorSets;	//i
+	VkPipelineLayout m_hizPipelineLayout;
+	VkPipeline m_hizPipeline;
+	bool m_depthHistory;			//[xobt@ɑOt[̌ʂcĂ邩
+	glm::mat4 m_prevViewProj;
+	uint32 m_hizReadbackLevel;		//CPUJOpɓǂݖ߂i
+	std::vector<BufferObj> m_hizReadbackBuffers;
+	std::vector<glm::mat4> m_hizReadbackViewProj;
+	std::vector<bool> m_hizReadbackValid;
+	HiZBuffer m_hizBuffer;
 };
 
 
@@ -38,10 +38,13 @@ static VkBool32 VKAPI_CALL DebugReportCallback(
 
 VulkanAppBase::
 VulkanAppBase()
-: m_vkInstance()
+: m_window()
+, m_vkInstance()
 , m_vkDevice()
 , m_vkPhysicalDevice()
 , m_vkDeviceMemProps()
+, m_vkDeviceFeatures()
+, m_vkDescriptorIndexing()
 , m_vkQueue()
 , m_vkCommandPool()
 , m_surface()
@@ -61,8 +64,21 @@ VulkanAppBase()
 , m_renderCompletedSem()
 , m_presentCompletedSem()
 , m_commands()
+, m_secondaryCommands(false)
+, m_secondaryPools()
+, m_secondaryThreadCount(0)
+, m_retiredResources()
 , m_graphicsQueueIndex(0)
 , m_imageIndex(0)
+, m_timestampPool()
+, m_timestampPeriod(0.0)
+, m_timestampMask(0)
+, m_timestampWritten()
+, m_lastFrameTick(0)
+, m_statsFrames(0)
+, m_statsGpuFrames(0)
+, m_statsCpuMs(0.0)
+, m_statsGpuMs(0.0)
 , m_vkCreateDebugReportCallbackEXT()
 , m_vkDebugReportMessageEXT()
 , m_vkDestroyDebugReportCallbackEXT()
@@ -80,6 +96,8 @@ VulkanAppBase::
 void VulkanAppBase::
 initialize(GLFWwindow* window, const char* appName)
 {
+	m_window = window;
+
 	//CX^X쐬
 	_CreateInstance(appName);
 
@@ -118,6 +136,8 @@ initialize(GLFWwindow* window, const char* appName)
 
 	//`t[p
 	_CreateSemaphores();
+	//t[Ԍvp
+	_CreateTimestampQueries();
 
 	prepare();
 }
@@ -127,7 +147,9 @@ terminate()
 	vkDeviceWaitIdle(m_vkDevice);
 
 	cleanup();
+	_ReleaseRetiredResources(~0u);
 
+	_DestroySecondaryCommandPools();
 	vkFreeCommandBuffers(m_vkDevice, m_vkCommandPool, uint32_t(m_commands.size()), m_commands.data());
 	m_commands.clear();
 
@@ -156,6 +178,10 @@ terminate()
 	m_fences.clear();
 	vkDestroySemaphore(m_vkDevice, m_presentCompletedSem, nullptr);
 	vkDestroySemaphore(m_vkDevice, m_renderCompletedSem, nullptr);
+	if (m_timestampPool != VK_NULL_HANDLE)
+	{
+		vkDestroyQueryPool(m_vkDevice, m_timestampPool, nullptr);
+	}
 
 	vkDestroyCommandPool(m_vkDevice, m_vkCommandPool, nullptr);
 
@@ -173,6 +199,8 @@ render()
 	vkAcquireNextImageKHR(m_vkDevice, m_swapchain, UINT64_MAX, m_presentCompletedSem, VK_NULL_HANDLE, &nextImageIndex);
 	auto commandFence = m_fences[nextImageIndex];
 	vkWaitForFences(m_vkDevice, 1, &commandFence, VK_TRUE, UINT64_MAX);
+	_UpdateFrameStats(nextImageIndex);
+	_ReleaseRetiredResources(nextImageIndex);
 
 	// NAl
 	std::array<VkClearValue, 2> clearValue = {
@@ -195,13 +223,32 @@ render()
 	commandBI.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 	auto& command = m_commands[nextImageIndex];
 	vkBeginCommandBuffer(command, &commandBI);
-	vkCmdBeginRenderPass(command, &renderPassBI, VK_SUBPASS_CONTENTS_INLINE);
+	if (m_timestampPool != VK_NULL_HANDLE)
+	{
+		vkCmdResetQueryPool(command, m_timestampPool, nextImageIndex * 2, 2);
+		vkCmdWriteTimestamp(command, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, m_timestampPool, nextImageIndex * 2);
+	}
 
 	m_imageIndex = nextImageIndex;
+	//̃C[W̃ZJ_̓tFX҂̂ŋL^
+	for (uint32 thread=0; thread<m_secondaryThreadCount; ++thread)
+	{
+		auto& pool = m_secondaryPools[nextImageIndex * m_secondaryThreadCount + thread];
+		vkResetCommandPool(m_vkDevice, pool.pool, 0);
+		pool.used = 0;
+	}
+	makePrePassCommand(command);
+
+	vkCmdBeginRenderPass(command, &renderPassBI, m_secondaryCommands ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE);
 	makeCommand(command);
 
 	// R}hE_[pXI
 	vkCmdEndRenderPass(command);
+	if (m_timestampPool != VK_NULL_HANDLE)
+	{
+		vkCmdWriteTimestamp(command, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, m_timestampPool, nextImageIndex * 2 + 1);
+		m_timestampWritten[nextImageIndex] = true;
+	}
 	vkEndCommandBuffer(command);
 
 	// R}hsiM)
@@ -233,6 +280,21 @@ render()
 
 
 
+/*virtual*/
+void VulkanAppBase::
+reportFrameStats(float64 cpuMs, float64 gpuMs)
+{
+	std::stringstream ss;
+	ss << "[Frame] cpu " << cpuMs << "ms";
+	if (gpuMs >= 0.0)
+	{
+		ss << " gpu " << gpuMs << "ms";
+	}
+	ss << std::endl;
+	OutputDebugStringA(ss.str().c_str());
+}
+
+
 void VulkanAppBase::
 _EnableDebugReport()
 {
@@ -357,12 +419,42 @@ _CreateDevice(void)
 		extentions.push_back(v.extensionName);
 	}
 
+	//gp@\̂ΉĂ̂Lɂ
+	VkPhysicalDeviceFeatures supported{};
+	vkGetPhysicalDeviceFeatures(m_vkPhysicalDevice, &supported);
+	m_vkDeviceFeatures = VkPhysicalDeviceFeatures{};
+	m_vkDeviceFeatures.multiDrawIndirect = supported.multiDrawIndirect;
+	m_vkDeviceFeatures.drawIndirectFirstInstance = supported.drawIndirectFirstInstance;
+	m_vkDeviceFeatures.shaderSampledImageArrayDynamicIndexing = supported.shaderSampledImageArrayDynamicIndexing;
+
+	//fBXNv^CfbNX̓oChX̃eNX`zɎgLɂ
+	bool descriptorIndexing = false;
+	for (const auto& v : extProps)
+	{
+		descriptorIndexing |= (strcmp(v.extensionName, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) == 0);
+	}
+	m_vkDescriptorIndexing = VkPhysicalDeviceDescriptorIndexingFeaturesEXT{};
+	m_vkDescriptorIndexing.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+	if (descriptorIndexing)
+	{
+		VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingSupported{};
+		indexingSupported.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+		VkPhysicalDeviceFeatures2 supported2{};
+		supported2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+		supported2.pNext = &indexingSupported;
+		vkGetPhysicalDeviceFeatures2(m_vkPhysicalDevice, &supported2);
+		m_vkDescriptorIndexing.runtimeDescriptorArray = indexingSupported.runtimeDescriptorArray;
+		m_vkDescriptorIndexing.descriptorBindingPartiallyBound = indexingSupported.descriptorBindingPartiallyBound;
+	}
+
 	VkDeviceCreateInfo deviceInfo{};
 	deviceInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+	deviceInfo.pNext = descriptorIndexing ? &m_vkDescriptorIndexing : nullptr;
 	deviceInfo.pQueueCreateInfos = &createInfo;
 	deviceInfo.queueCreateInfoCount = 1;
 	deviceInfo.ppEnabledExtensionNames = extentions.data();
 	deviceInfo.enabledExtensionCount = static_cast<uint32>(extentions.size());
+	deviceInfo.pEnabledFeatures = &m_vkDeviceFeatures;
 
 	VkResult result = vkCreateDevice(m_vkPhysicalDevice, &deviceInfo, nullptr, &m_vkDevice);
 
@@ -457,7 +549,8 @@ _CreateDepthBuffer()
 	ci.extent.height = m_swapchainExtent.height;
 	ci.extent.depth = 1;
 	ci.mipLevels = 1;
-	ci.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+	//Օp̐[xs~bh邽߃VF[_[ǂ
+	ci.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 	ci.samples = VK_SAMPLE_COUNT_1_BIT;
 	ci.arrayLayers = 1;
 	auto result = vkCreateImage(m_vkDevice, &ci, nullptr, &m_depthBuffer);
@@ -639,4 +732,163 @@ _CreateSemaphores()
 	ci.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 	vkCreateSemaphore(m_vkDevice, &ci, nullptr, &m_renderCompletedSem);
 	vkCreateSemaphore(m_vkDevice, &ci, nullptr, &m_presentCompletedSem);
+}
+
+void VulkanAppBase::
+_CreateTimestampQueries()
+{
+	//^CX^vɑΉĂȂGPUԂ͌vȂ
+	uint32 propCount = 0;
+	vkGetPhysicalDeviceQueueFamilyProperties(m_vkPhysicalDevice, &propCount, nullptr);
+	std::vector<VkQueueFamilyProperties> props(propCount);
+	vkGetPhysicalDeviceQueueFamilyProperties(m_vkPhysicalDevice, &propCount, props.data());
+	uint32 validBits = (m_graphicsQueueIndex < propCount) ? props[m_graphicsQueueIndex].timestampValidBits : 0;
+	if (validBits == 0)
+	{
+		return;
+	}
+	VkPhysicalDeviceProperties deviceProps;
+	vkGetPhysicalDeviceProperties(m_vkPhysicalDevice, &deviceProps);
+	m_timestampPeriod = deviceProps.limits.timestampPeriod;
+	m_timestampMask = (validBits >= 64) ? ~0ull : ((1ull << validBits) - 1);
+
+	VkQueryPoolCreateInfo ci{};
+	ci.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+	ci.queryType = VK_QUERY_TYPE_TIMESTAMP;
+	ci.queryCount = uint32(m_commands.size()) * 2;
+	vkCreateQueryPool(m_vkDevice, &ci, nullptr, &m_timestampPool);
+	m_timestampWritten.assign(m_commands.size(), false);
+}
+
+void VulkanAppBase::
+_UpdateFrameStats(uint32 imageIndex)
+{
+	const uint32 StatsInterval = 120;
+
+	//CPU͑Ot[̌oߎ
+	LARGE_INTEGER now, freq;
+	QueryPerformanceCounter(&now);
+	QueryPerformanceFrequency(&freq);
+	if (m_lastFrameTick != 0)
+	{
+		m_statsCpuMs += float64(now.QuadPart - m_lastFrameTick) * 1000.0 / float64(freq.QuadPart);
+		++m_statsFrames;
+	}
+	m_lastFrameTick = now.QuadPart;
+
+	//GPU͂̃C[WőOς񂾃R}h̊JnI܂(tFX҂ς)
+	if (m_timestampPool != VK_NULL_HANDLE && m_timestampWritten[imageIndex])
+	{
+		uint64 ticks[2] = {};
+		if (vkGetQueryPoolResults(m_vkDevice, m_timestampPool, imageIndex * 2, 2, sizeof(ticks), ticks, sizeof(uint64), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+		{
+			uint64 elapsed = ((ticks[1] & m_timestampMask) - (ticks[0] & m_timestampMask)) & m_timestampMask;
+			m_statsGpuMs += float64(elapsed) * m_timestampPeriod * 1.0e-6;
+			++m_statsGpuFrames;
+		}
+	}
+
+	if (m_statsFrames >= StatsInterval)
+	{
+		reportFrameStats(m_statsCpuMs / m_statsFrames, (m_statsGpuFrames > 0) ? m_statsGpuMs / m_statsGpuFrames : -1.0);
+		m_statsFrames = 0;
+		m_statsGpuFrames = 0;
+		m_statsCpuMs = 0.0;
+		m_statsGpuMs = 0.0;
+	}
+}
+
+void VulkanAppBase::
+_CreateSecondaryCommandPools(uint32 threadCount)
+{
+	_DestroySecondaryCommandPools();
+
+	//t[L^̂ŁAv[Ƃ܂Ƃ߂ăZbg
+	VkCommandPoolCreateInfo info{};
+	info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+	info.queueFamilyIndex = m_graphicsQueueIndex;
+	info.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+	m_secondaryThreadCount = threadCount;
+	m_secondaryPools.resize(m_commands.size() * threadCount);
+	for (auto& v : m_secondaryPools)
+	{
+		vkCreateCommandPool(m_vkDevice, &info, nullptr, &v.pool);
+		v.used = 0;
+	}
+}
+
+void VulkanAppBase::
+_DestroySecondaryCommandPools(void)
+{
+	//v[j΃ZJ_
+	for (auto& v : m_secondaryPools)
+	{
+		vkDestroyCommandPool(m_vkDevice, v.pool, nullptr);
+	}
+	m_secondaryPools.clear();
+	m_secondaryThreadCount = 0;
+}
+
+VkCommandBuffer VulkanAppBase::
+_BeginSecondaryCommand(uint32 thread)
+{
+	auto& pool = m_secondaryPools[m_imageIndex * m_secondaryThreadCount + thread];
+	if (pool.used == pool.buffers.size())
+	{
+		VkCommandBufferAllocateInfo ai{};
+		ai.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		ai.commandPool = pool.pool;
+		ai.commandBufferCount = 1;
+		ai.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		VkCommandBuffer command;
+		vkAllocateCommandBuffers(m_vkDevice, &ai, &command);
+		pool.buffers.push_back(command);
+	}
+	auto command = pool.buffers[pool.used++];
+
+	VkCommandBufferInheritanceInfo inheritance{};
+	inheritance.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+	inheritance.renderPass = m_renderPass;
+	inheritance.subpass = 0;
+	inheritance.framebuffer = m_framebuffers[m_imageIndex];
+	VkCommandBufferBeginInfo commandBI{};
+	commandBI.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+	commandBI.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+	commandBI.pInheritanceInfo = &inheritance;
+	vkBeginCommandBuffer(command, &commandBI);
+	return command;
+}
+
+void VulkanAppBase::
+_RetireResource(std::function<void()> release)
+{
+	//L^̃t[̃C[W܂߁ASC[W̃tFX҂܂Ŏc
+	uint64 pending = (uint64(1) << m_commands.size()) - 1;
+	m_retiredResources.push_back(RetiredResource{ std::move(release), pending });
+}
+
+void VulkanAppBase::
+_ReleaseRetiredResources(uint32 imageIndex)
+{
+	uint64 waited = (imageIndex == ~0u) ? ~uint64(0) : (uint64(1) << imageIndex);
+	size_t kept = 0;
+	for (size_t idx=0; idx<m_retiredResources.size(); ++idx)
+	{
+		auto& retired = m_retiredResources[idx];
+		retired.pendingImages &= ~waited;
+		if (retired.pendingImages == 0)
+		{
+			retired.release();
+		}
+		else
+		{
+			//Âۂ܂܋l߂
+			if (kept != idx)
+			{
+				m_retiredResources[kept] = std::move(retired);
+			}
+			++kept;
+		}
+	}
+	m_retiredResources.resize(kept);
 }
\ No newline at end of file
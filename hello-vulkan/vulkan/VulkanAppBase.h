@@ -1,6 +1,7 @@
 #ifndef __Vulkan_VulkanAppBase_H__
 #define __Vulkan_VulkanAppBase_H__
 
+#include <functional>
 
 
 //Vulkan̎͂ɉ߂
@@ -19,7 +20,11 @@ public:
 	render();
 	virtual void prepare() { }
 	virtual void cleanup() { }
+	//_[pXJnOɐςރR}h(Rs[gȂ)
+	virtual void makePrePassCommand(VkCommandBuffer command) { }
 	virtual void makeCommand(VkCommandBuffer command) { }
+	//t[Ƃ̕σt[(GPUԂȂꍇ͕̒l)
+	virtual void reportFrameStats(float64 cpuMs, float64 gpuMs);
 
 
 
@@ -54,13 +59,36 @@ protected:
 	_CreateCommandBuffers();
 	void
 	_CreateSemaphores();
+	void
+	_CreateTimestampQueries();
+	void
+	_UpdateFrameStats(uint32 imageIndex);
+	//C[WƂthreadCount̃ZJ_R}hobt@p̃v[
+	void
+	_CreateSecondaryCommandPools(uint32 threadCount);
+	void
+	_DestroySecondaryCommandPools(void);
+	//݂̃C[WthreadԖڂ̃v[ZJ_oA_[pX̑ƂċL^n߂
+	//v[̓XbhƂȂ̂ŁAthread𓯎ɕ̃XbhgȂ
+	VkCommandBuffer
+	_BeginSecondaryCommand(uint32 thread);
+	//܂łɐς񂾃R}hׂďIĂ(eC[W̃tFX1x҂)releaseĂ
+	//`ɎgĂ邩ȂvkDeviceWaitIdleɎ̂ĂƂɎg
+	void
+	_RetireResource(std::function<void()> release);
+	//imageIndex̃tFX҂ɌĂ ~0uȂcׂĊJ(foCX҂̂)
+	void
+	_ReleaseRetiredResources(uint32 imageIndex);
 
 
 protected:
+	GLFWwindow* m_window;
 	VkInstance m_vkInstance;
 	VkDevice m_vkDevice;
 	VkPhysicalDevice m_vkPhysicalDevice;
 	VkPhysicalDeviceMemoryProperties m_vkDeviceMemProps;
+	VkPhysicalDeviceFeatures m_vkDeviceFeatures;	//foCX쐬ɗL@\
+	VkPhysicalDeviceDescriptorIndexingFeaturesEXT m_vkDescriptorIndexing;	//(VK_EXT_descriptor_indexing ΉȂSĖ)
 	VkQueue m_vkQueue;
 	VkCommandPool m_vkCommandPool;
 
@@ -87,9 +115,39 @@ protected:
 
 	std::vector<VkCommandBuffer> m_commands;
 
+	//trueȂ烌_[pXZJ_pŊJn(makeCommandłvkCmdExecuteCommandŝݐς߂)
+	bool m_secondaryCommands;
+	struct SecondaryCommandPool
+	{
+		VkCommandPool pool;
+		std::vector<VkCommandBuffer> buffers;	//t[܂Ŏg
+		uint32 used;
+	};
+	std::vector<SecondaryCommandPool> m_secondaryPools;	//C[W~Xbh
+	uint32 m_secondaryThreadCount;
+
+	//J҂̎
+	struct RetiredResource
+	{
+		std::function<void()> release;
+		uint64 pendingImages;	//܂tFX҂ĂȂC[W̃rbg
+	};
+	std::vector<RetiredResource> m_retiredResources;
+
 	uint32 m_graphicsQueueIndex;
 	uint32  m_imageIndex;
 
+	//t[Ԍv(C[WƂɊJnEĨ^CX^v)
+	VkQueryPool m_timestampPool;
+	float64 m_timestampPeriod;			//1tick̃imb
+	uint64 m_timestampMask;
+	std::vector<bool> m_timestampWritten;
+	int64 m_lastFrameTick;
+	uint32 m_statsFrames;
+	uint32 m_statsGpuFrames;
+	float64 m_statsCpuMs;
+	float64 m_statsGpuMs;
+
 
 private://Debug
 	void